@@ -0,0 +1,30 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "AssetArchive.h"
+
+
+// Pack the files of the game's asset directories into an archive. Runs after every build of the
+// game, so it only depends on AssetArchive: no SFML & no assumption about the working directory.
+// Usage: AssetPacker <archive> <asset root> <directory>...
+int main(int argc, char* argv[]) {
+	if (argc < 4) {
+		std::cerr << "usage: AssetPacker <archive> <asset root> <directory>...\n";
+		return 2;
+	}
+
+	const std::string root{ argv[2] };
+	std::vector<std::string> names;
+	for (int i = 3; i < argc; i++) {
+		if (!AssetArchive::listFiles(root, argv[i], names)) {
+			std::cerr << "AssetPacker: could not read " << root << "/" << argv[i] << "\n";
+			return 1;
+		}
+	}
+	if (!AssetArchive::pack(argv[1], root, names)) {
+		std::cerr << "AssetPacker: could not write " << argv[1] << "\n";
+		return 1;
+	}
+	std::cout << "packed " << names.size() << " files into " << argv[1] << "\n";
+	return 0;
+}
@@ -0,0 +1,218 @@
+#include "AssetArchive.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+	const char FILE_MAGIC[4] = { 'T', 'P', 'A', 'K' };
+	const std::uint32_t FILE_VERSION = 1;
+	const std::uint64_t DATA_ALIGNMENT = 16;
+
+	void writeU32(std::ofstream& out, std::uint32_t value) {
+		for (int i = 0; i < 4; i++)
+			out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+
+	void writeU64(std::ofstream& out, std::uint64_t value) {
+		for (int i = 0; i < 8; i++)
+			out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+
+	// Read a little endian value from the mapping, advancing pos.
+	// @return: False if it would read past the end.
+	template<typename T>
+	bool readLE(const std::uint8_t* base, std::size_t size, std::size_t& pos, T& value) {
+		if (size - pos < sizeof(T))
+			return false;
+		value = 0;
+		for (std::size_t i = 0; i < sizeof(T); i++)
+			value |= static_cast<T>(base[pos + i]) << (8 * i);
+		pos += sizeof(T);
+		return true;
+	}
+}
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+bool AssetArchive::pack(const std::string& path, const std::string& root, const std::vector<std::string>& names) {
+	std::vector<std::vector<char>> contents;
+	for (const std::string& name : names) {
+		std::ifstream in(root.empty() ? name : root + "/" + name, std::ios::binary);
+		if (!in)
+			return false;
+		contents.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+
+	std::uint64_t offset{ sizeof(FILE_MAGIC) + 4 + 4 };
+	for (const std::string& name : names)
+		offset += 4 + normalizeName(name).size() + 8 + 8;
+
+	std::ofstream out(path, std::ios::binary);
+	if (!out)
+		return false;
+	out.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+	writeU32(out, FILE_VERSION);
+	writeU32(out, static_cast<std::uint32_t>(names.size()));
+	std::vector<std::uint64_t> offsets;
+	for (std::size_t i = 0; i < names.size(); i++) {
+		std::string name = normalizeName(names[i]);
+		offset = (offset + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+		offsets.push_back(offset);
+		writeU32(out, static_cast<std::uint32_t>(name.size()));
+		out.write(name.data(), name.size());
+		writeU64(out, offset);
+		writeU64(out, contents[i].size());
+		offset += contents[i].size();
+	}
+	for (std::size_t i = 0; i < names.size(); i++) {
+		while (static_cast<std::uint64_t>(out.tellp()) < offsets[i])
+			out.put('\0');
+		out.write(contents[i].data(), contents[i].size());
+	}
+	return static_cast<bool>(out);
+}
+
+bool AssetArchive::listFiles(const std::string& root, const std::string& dir, std::vector<std::string>& names) {
+	const std::string path{ root.empty() ? dir : root + "/" + dir };
+	std::vector<std::string> found;
+#ifdef _WIN32
+	WIN32_FIND_DATAA entry;
+	HANDLE search = FindFirstFileA((path + "/*").c_str(), &entry);
+	if (search == INVALID_HANDLE_VALUE)
+		return false;
+	do {
+		if (!(entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+			found.push_back(dir + "/" + entry.cFileName);
+	} while (FindNextFileA(search, &entry));
+	FindClose(search);
+#else
+	DIR* listing = opendir(path.c_str());
+	if (!listing)
+		return false;
+	while (dirent* entry = readdir(listing)) {
+		struct stat info;
+		if (stat((path + "/" + entry->d_name).c_str(), &info) == 0 && S_ISREG(info.st_mode))
+			found.push_back(dir + "/" + entry->d_name);
+	}
+	closedir(listing);
+#endif
+	std::sort(found.begin(), found.end());
+	names.insert(names.end(), found.begin(), found.end());
+	return true;
+}
+
+bool AssetArchive::open(const std::string& path) {
+	close();
+	if (!map(path))
+		return false;
+	if (!readIndex()) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void AssetArchive::close() {
+	if (base) {
+#ifdef _WIN32
+		UnmapViewOfFile(base);
+#else
+		munmap(const_cast<std::uint8_t*>(base), size);
+#endif
+	}
+	base = nullptr;
+	size = 0;
+	index.clear();
+}
+
+const AssetArchive::Entry* AssetArchive::find(const std::string& name) const {
+	std::string key = normalizeName(name);
+	auto it = std::lower_bound(index.begin(), index.end(), key,
+		[](const IndexEntry& entry, const std::string& key) { return entry.name < key; });
+	return it != index.end() && it->name == key ? &it->entry : nullptr;
+}
+
+// PRIVATE METHODS ---------------------------------------
+
+std::string AssetArchive::normalizeName(const std::string& name) {
+	std::string normalized;
+	for (char c : name)
+		normalized += c == '\\' ? '/' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	return normalized;
+}
+
+bool AssetArchive::map(const std::string& path) {
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER fileSize;
+	HANDLE mapping = nullptr;
+	if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);		// the mapping keeps the file open
+	if (!mapping)
+		return false;
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);	// the view keeps the mapping alive
+	if (!view)
+		return false;
+	base = static_cast<const std::uint8_t*>(view);
+	size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+	struct stat info;
+	void* view = MAP_FAILED;
+	if (fstat(file, &info) == 0 && info.st_size > 0)
+		view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	::close(file);			// the mapping keeps the file open
+	if (view == MAP_FAILED)
+		return false;
+	base = static_cast<const std::uint8_t*>(view);
+	size = static_cast<std::size_t>(info.st_size);
+#endif
+	return true;
+}
+
+bool AssetArchive::readIndex() {
+	std::size_t pos{ 0 };
+	std::uint32_t version, count;
+	if (size < sizeof(FILE_MAGIC) || !std::equal(FILE_MAGIC, FILE_MAGIC + sizeof(FILE_MAGIC), base))
+		return false;
+	pos += sizeof(FILE_MAGIC);
+	if (!readLE(base, size, pos, version) || version != FILE_VERSION || !readLE(base, size, pos, count))
+		return false;
+
+	for (std::uint32_t i = 0; i < count; i++) {
+		std::uint32_t nameLength;
+		std::uint64_t offset, length;
+		if (!readLE(base, size, pos, nameLength) || size - pos < nameLength)
+			return false;
+		std::string name(reinterpret_cast<const char*>(base + pos), nameLength);
+		pos += nameLength;
+		if (!readLE(base, size, pos, offset) || !readLE(base, size, pos, length))
+			return false;
+		if (offset > size || length > size - offset)
+			return false;
+		index.push_back({ name, { base + offset, static_cast<std::size_t>(length) } });
+	}
+	std::sort(index.begin(), index.end(),
+		[](const IndexEntry& a, const IndexEntry& b) { return a.name < b.name; });
+	return true;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * The AssetArchive class packs the game's asset files into one indexed archive and reads them back
+ * by memory-mapping it, so loading every asset costs a single file open and the OS only pages in
+ * what is actually used. find() returns a view into the mapping, meant for SFML's loadFromMemory()
+ * & openFromMemory(); the archive must stay open as long as anything (e.g. a streamed sf::Music or
+ * an sf::Font) still reads from it.
+ *
+ * Layout, little endian: "TPAK", u32 version, u32 entry count, then per entry: u32 name length,
+ * name, u64 offset, u64 size; then the data of each entry at its offset, 16 byte aligned.
+ * Names are relative paths with '/' separators, matched case insensitively.
+ */
+class AssetArchive {
+	friend class TestSuite;
+
+public:
+	// A view of one packed file inside the mapping.
+	struct Entry {
+		const void* data;
+		std::size_t size;
+	};
+
+private:
+	struct IndexEntry {
+		std::string name;		// Normalized, see normalizeName().
+		Entry entry;
+	};
+
+	const std::uint8_t* base{ nullptr };	// Start of the mapping, null when closed.
+	std::size_t size{ 0 };					// Size of the mapping in bytes.
+	std::vector<IndexEntry> index;			// Sorted by name.
+
+public:
+	AssetArchive() {}
+	AssetArchive(const AssetArchive&) = delete;
+	AssetArchive& operator=(const AssetArchive&) = delete;
+	~AssetArchive() { close(); }
+
+	// Pack files into an archive.
+	// @param path: The archive to write.
+	// @param root: Directory the names are relative to, empty for the working directory.
+	// @param names: The files to pack, e.g. "images/tiles.png".
+	// @return: False if a file couldn't be read or the archive written.
+	static bool pack(const std::string& path, const std::string& root, const std::vector<std::string>& names);
+
+	// List the files of a directory (not its subdirectories), for packing them.
+	// @param root: Directory the names are relative to, empty for the working directory.
+	// @param dir: The directory to list, relative to root, e.g. "images".
+	// @param names: Where to add the names, e.g. "images/tiles.png", in sorted order.
+	// @return: False if the directory couldn't be read.
+	static bool listFiles(const std::string& root, const std::string& dir, std::vector<std::string>& names);
+
+	// Memory-map an archive & read its index. Closes any archive open before.
+	// @param path: The archive file.
+	// @return: False if it couldn't be mapped or isn't a valid archive.
+	bool open(const std::string& path);
+
+	// Unmap the archive. Every Entry found before becomes invalid.
+	void close();
+
+	bool isOpen() const { return base != nullptr; }
+
+	// Find a packed file.
+	// @param name: Its name when packed, e.g. "images/tiles.png".
+	// @return: A pointer to its entry, or nullptr if it isn't in the archive.
+	const Entry* find(const std::string& name) const;
+
+	// @return: Number of files in the archive.
+	std::size_t getEntryCount() const { return index.size(); }
+
+private:
+	// Lower case a name & turn '\' into '/', so lookups don't depend on the platform's case rules.
+	static std::string normalizeName(const std::string& name);
+
+	// Map a whole file read only.
+	// @return: False if the file couldn't be mapped (an empty file can't be).
+	bool map(const std::string& path);
+
+	// Read the index of the mapped file & check every entry lies within it.
+	bool readIndex();
+};
@@ -0,0 +1,87 @@
+#include "AssetLoader.h"
+#include <cassert>
+#include <chrono>
+#include <iterator>
+
+
+// STATIC CONSTANTS ======================================
+
+const char* const AssetLoader::BACKGROUND_PATH{ "images/background.png" };
+const char* const AssetLoader::TILES_PATH{ "images/tiles.png" };
+const char* const AssetLoader::FONT_PATH{ "fonts/RedOctober.ttf" };
+
+// CONSTRUCTOR -------------------------------------------
+
+AssetLoader::AssetLoader(StartupProfile& profile, const AssetArchive* archive)
+	: profile(profile), archive(archive)
+{
+	backgroundLoad = launch("load background.png", [this]() {
+		return loadAsset(backgroundImage, BACKGROUND_PATH);
+	});
+	blockLoad = launch("load tiles.png", [this]() {
+		return loadAsset(blockImage, TILES_PATH);
+	});
+	fontLoad = launch("load RedOctober.ttf", [this]() {
+		return loadAsset(scoreFont, FONT_PATH);
+	});
+	audioLoad = launch("load audio", [archive]() {
+		std::unique_ptr<GameAudio> audio(new GameAudio());
+		if (!audio->load(archive)) {
+			audio.reset();
+		}
+		return audio;
+	});
+}
+
+AssetLoader::~AssetLoader() {
+	for (std::future<bool>* load : { &backgroundLoad, &blockLoad, &fontLoad }) {
+		if (load->valid()) {
+			load->wait();
+		}
+	}
+	if (audioLoad.valid()) {
+		audioLoad.wait();
+	}
+}
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+bool AssetLoader::loadTextures(sf::Texture& backgroundTexture, sf::Texture& blockTexture) {
+	bool loaded = backgroundLoad.get() && blockLoad.get();
+	StartupProfile::Scope scope(profile, "create textures");
+	return loaded && backgroundTexture.loadFromImage(backgroundImage) && blockTexture.loadFromImage(blockImage);
+}
+
+const sf::Font& AssetLoader::getFont() {
+	if (fontLoad.valid() && !fontLoad.get()) {
+		assert(false && "Missing font: RedOctober.ttf");
+	}
+	return scoreFont;
+}
+
+bool AssetLoader::isAudioReady() const {
+	return audioLoad.valid() && audioLoad.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+std::unique_ptr<GameAudio> AssetLoader::takeAudio() {
+	return audioLoad.get();
+}
+
+// PRIVATE METHODS ---------------------------------------
+
+template<typename Asset>
+bool AssetLoader::loadAsset(Asset& asset, const char* name) const {
+	if (!archive) {
+		return asset.loadFromFile(name);
+	}
+	const AssetArchive::Entry* entry = archive->find(name);
+	return entry && asset.loadFromMemory(entry->data, entry->size);
+}
+
+template<typename Load>
+auto AssetLoader::launch(const char* name, Load load) -> std::future<decltype(load())> {
+	return std::async(std::launch::async, [this, name, load]() {
+		StartupProfile::Scope scope(profile, name);
+		return load();
+	});
+}
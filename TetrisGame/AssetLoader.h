@@ -0,0 +1,80 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <future>
+#include <memory>
+#include <string>
+#include "AssetArchive.h"
+#include "GameAudio.h"
+#include "StartupProfile.h"
+
+/*
+ * The AssetLoader class loads the game's images, font & audio concurrently on worker threads as
+ * soon as it is constructed. Images are only decoded off the main thread; the textures are created
+ * from them by loadTextures() on the thread that owns the GL context. Each load is recorded in the
+ * StartupProfile. The window can be shown once the textures & font are ready, and the audio
+ * attached to the game whenever it finishes.
+ * Assets are read from an AssetArchive when one is given, otherwise from loose files relative to
+ * the working directory.
+ */
+class AssetLoader {
+public:
+	// Static Constants ============================================================================
+	static const char* const BACKGROUND_PATH;
+	static const char* const TILES_PATH;
+	static const char* const FONT_PATH;
+
+private:
+	StartupProfile& profile;
+	const AssetArchive* archive;			// Null to load loose files.
+	sf::Image backgroundImage;				// Decoded images/background.png
+	sf::Image blockImage;					// Decoded images/tiles.png
+	sf::Font scoreFont;						// fonts/RedOctober.ttf
+	std::future<bool> backgroundLoad;
+	std::future<bool> blockLoad;
+	std::future<bool> fontLoad;
+	std::future<std::unique_ptr<GameAudio>> audioLoad;
+
+public:
+	// Constructor
+	// Starts every load on its own worker thread.
+	// @param profile: Where each load is recorded, must outlive the loader.
+	// @param archive: The archive to load from, or nullptr for loose files. Must outlive the loader,
+	// the font & the audio.
+	AssetLoader(StartupProfile& profile, const AssetArchive* archive);
+
+	// Waits for the images & creates the textures from them. Call on the thread drawing them.
+	// @param backgroundTexture: Set to the window background.
+	// @param blockTexture: Set to the tetromino tile sheet.
+	// @return: True if both textures were created.
+	bool loadTextures(sf::Texture& backgroundTexture, sf::Texture& blockTexture);
+
+	// Waits for the font.
+	// @return: The score font, owned by the loader.
+	const sf::Font& getFont();
+
+	// @return: True once the audio has loaded and hasn't been taken yet.
+	bool isAudioReady() const;
+
+	// Takes the loaded audio, waiting for it if necessary. Only call once.
+	// @return: The audio, or nullptr if it failed to load.
+	std::unique_ptr<GameAudio> takeAudio();
+
+	// Wait for every load to finish, e.g. before leaving main().
+	~AssetLoader();
+
+private:
+	// Load an image or font from the archive, or from its file if there's no archive.
+	// @param asset: The sf::Image or sf::Font to load.
+	// @param name: Its path, e.g. "images/tiles.png".
+	// @return: True if it loaded.
+	template<typename Asset>
+	bool loadAsset(Asset& asset, const char* name) const;
+
+	// Run a load on a worker thread & record it in the profile.
+	// @param name: Name of the stage in the profile.
+	// @param load: The load to run.
+	// @return: The future result of the load.
+	template<typename Load>
+	auto launch(const char* name, Load load) -> std::future<decltype(load())>;
+};
@@ -0,0 +1,154 @@
+#include "BeamSearch.h"
+#include <algorithm>
+#include <chrono>
+
+// STATIC CONSTANTS ======================================
+
+const int BeamSearchPolicy::TASKS;
+
+// CONSTRUCTOR -------------------------------------------
+
+BeamSearchPolicy::BeamSearchPolicy(const Config& config)
+	: config(config), pool(config.threads), table(config.pruneDuplicates ? config.tableBits : 0)
+{
+	this->config.beamWidth = std::max(1, this->config.beamWidth);
+	this->config.depth = std::max(1, std::min(this->config.depth, Randomizer::PREVIEW_CAPACITY + 1));
+	workers.resize(pool.getThreadCount());
+
+	const int maxPlacements{ Tetromino::ORIENTATION_COUNT * Gameboard::MAX_X };	// hard drops of one shape
+	for (Worker& worker : workers) {
+		worker.placements.reserve(maxPlacements);
+	}
+	beam.reserve(this->config.beamWidth * maxPlacements);
+	children.resize(TASKS);
+	expanded.resize(TASKS);
+	for (std::vector<Node>& taskChildren : children) {
+		taskChildren.reserve((this->config.beamWidth + TASKS - 1) / TASKS * maxPlacements);
+	}
+	shapes.reserve(this->config.depth);
+	expandTask = [this](int task, int thread) { expandNodes(task, workers[thread]); };
+}
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+Placement BeamSearchPolicy::choosePlacement(const TetrisEngine& engine) {
+	auto start = std::chrono::steady_clock::now();
+
+	// The shapes in view: current, next, then the ones the randomizer has dealt ahead.
+	shapes.clear();
+	shapes.push_back(engine.getCurrentShape().getShape());
+	if (config.depth > 1) {
+		shapes.push_back(engine.getNextShape().getShape());
+	}
+	for (int i = 0; static_cast<int>(shapes.size()) < config.depth; i++) {
+		shapes.push_back(engine.getRandomizer().peekShape(i));
+	}
+
+	beam.clear();
+	Node root;
+	root.board = Board(engine.getBoard());
+	root.features = Features(root.board);
+	root.reward = 0;
+	root.score = 0;
+	root.order = 0;
+	beam.push_back(root);
+
+	if (config.pruneDuplicates) {
+		table.newSearch();
+	}
+	stats.nodes = 0;
+	stats.duplicates = 0;
+	for (layer = 0; layer < config.depth; layer++) {
+		long long evaluated{ expandLayer() };
+		if (evaluated == 0)
+			break;		// every line of play tops out here: play the best board so far
+		stats.nodes += evaluated;
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	stats.seconds = elapsed.count();
+	stats.nodesPerSecond = stats.seconds > 0 ? stats.nodes / stats.seconds : 0;
+	return stats.nodes > 0 ? beam.front().first : Placement();
+}
+
+// PRIVATE METHODS ---------------------------------------
+
+long long BeamSearchPolicy::expandLayer() {
+	taskCount = std::min(TASKS, static_cast<int>(beam.size()));
+	pool.run(taskCount, expandTask);
+
+	long long evaluated{ 0 };
+	for (int task = 0; task < taskCount; task++) {
+		evaluated += expanded[task];
+	}
+	if (evaluated == 0)
+		return 0;
+
+	// Merge the tasks in order, so ties break the same way whatever the thread count.
+	beam.clear();
+	for (int task = 0; task < taskCount; task++) {
+		beam.insert(beam.end(), children[task].begin(), children[task].end());
+	}
+	stats.duplicates += evaluated - static_cast<long long>(beam.size());
+	for (int i = 0; i < static_cast<int>(beam.size()); i++) {
+		beam[i].order = i;
+	}
+
+	// Keep the best children, best first. Which copies of a board the table dropped depends on
+	// the timing of the threads, but the best copy is never dropped; skipping the copies left
+	// behind it makes the beam the same every time.
+	auto better = [](const Node& a, const Node& b) { return a.score > b.score || (a.score == b.score && a.order < b.order); };
+	int kept{ 0 };
+	auto next = beam.begin();
+	while (kept < config.beamWidth && next != beam.end()) {
+		auto last = next + std::min<std::ptrdiff_t>(config.beamWidth - kept, beam.end() - next);
+		if (last != beam.end()) {
+			std::nth_element(next, last, beam.end(), better);
+		}
+		std::sort(next, last, better);
+		for (; next != last; ++next) {
+			if (config.pruneDuplicates && isKept(next->board.getHash(), kept)) {
+				stats.duplicates++;
+				continue;
+			}
+			beam[kept++] = *next;
+		}
+	}
+	beam.resize(kept);
+	return evaluated;
+}
+
+bool BeamSearchPolicy::isKept(std::uint64_t hash, int kept) const {
+	for (int i = 0; i < kept; i++) {
+		if (beam[i].board.getHash() == hash)
+			return true;
+	}
+	return false;
+}
+
+void BeamSearchPolicy::expandNodes(int task, Worker& worker) {
+	const int nodeCount{ static_cast<int>(beam.size()) };
+	const TetShape shape{ shapes[layer] };
+	const std::uint64_t depthKey{ ZobristKeys<Gameboard::MAX_X, Gameboard::MAX_Y>::get().getDepthKey(layer) };
+	std::vector<Node>& out = children[task];
+	out.clear();
+	expanded[task] = 0;
+	for (int i = task * nodeCount / taskCount; i < (task + 1) * nodeCount / taskCount; i++) {
+		worker.generator.generate(beam[i].board, shape, worker.placements, false);	// applyPlacement() can't tuck
+		expanded[task] += static_cast<long long>(worker.placements.size());
+		for (const Placement& placement : worker.placements) {
+			out.push_back(beam[i]);
+			Node& child = out.back();
+			int rows{ child.features.place(child.board, PieceMask::get(shape, placement.orientation), placement.x, placement.y) };
+			child.score = child.reward + child.features.evaluate(config.weights);
+			child.reward += config.weights.linesCleared * rows;
+			if (layer == 0)
+				child.first = placement;
+
+			// Drop the child if a better copy of its board was made first (by any thread).
+			float score{ static_cast<float>(child.score) };
+			if (config.pruneDuplicates && table.store(child.board.getHash() ^ depthKey, score) > score)
+				out.pop_back();
+		}
+	}
+}
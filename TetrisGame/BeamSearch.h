@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "BoardFeatures.h"
+#include "MoveGenerator.h"
+#include "SelfPlay.h"
+#include "ThreadPool.h"
+#include "TranspositionTable.h"
+
+/*
+ * The BeamSearchPolicy class looks ahead over the shapes the player can see: the current shape,
+ * the next shape and, when configured deeper, the shapes after it (the Randomizer deals them
+ * ahead of time). Every layer places one shape on each board of the beam, evaluates the boards
+ * with BoardFeatures and keeps the best beamWidth of them; the first placement of the best board
+ * of the last layer is played. Layers are expanded in parallel on a ThreadPool, into buffers
+ * reserved up front, so a search doesn't allocate once the first one has run.
+ * A board reached by more than one order of placements is kept once, with its best score: the
+ * threads share a TranspositionTable to drop the worse copies as they make them, and the merge
+ * drops any copies the table missed. Both tell boards apart by their full 64-bit hash, so the
+ * choice doesn't depend on the thread count.
+ */
+class BeamSearchPolicy : public PlacementPolicy {
+	friend class TestSuite;
+
+public:
+	typedef MoveGenerator<Gameboard::MAX_X, Gameboard::MAX_Y> Generator;
+	typedef BoardFeatures<Gameboard::MAX_X, Gameboard::MAX_Y> Features;
+	typedef Generator::Board Board;
+
+	struct Config {
+		int beamWidth{ 32 };	// # of boards kept per layer.
+		int depth{ 2 };			// # of shapes looked at, the current one included.
+		int threads{ 1 };		// # of threads expanding a layer, 0 for one per core.
+		bool pruneDuplicates{ true };	// Keep one copy of boards reached by different placement orders.
+		int tableBits{ 12 };	// log2 of the # of transposition table buckets.
+		EvaluationWeights weights;
+	};
+
+	// A board of the beam. Copied for every child, so it must stay small & trivially copyable.
+	struct Node {
+		Board board;
+		Features features;
+		double reward;		// Weighted lines cleared on the way to this board.
+		double score;		// reward + the evaluation of the board.
+		Placement first;	// Placement of the current shape this board descends from.
+		int order;			// Position among the children of its layer, breaks ties.
+	};
+	static_assert(std::is_trivially_copyable<Node>::value, "Beam nodes are copied into every child");
+
+	// Search effort of the last choosePlacement().
+	struct Stats {
+		long long nodes{ 0 };	// # of boards evaluated.
+		long long duplicates{ 0 };	// # of boards dropped as copies of better ones.
+		double seconds{ 0 };
+		double nodesPerSecond{ 0 };
+	};
+
+private:
+	static const int TASKS = 16;	// Tasks a layer is split into, fixed so the result doesn't depend on the threads
+
+	struct Worker {
+		Generator generator;
+		std::vector<Placement> placements;
+	};
+
+	Config config;
+	ThreadPool pool;
+	TranspositionTable table;					// Best score of each board of the search, shared by the threads
+	std::vector<Worker> workers;				// One per thread of the pool
+	std::vector<Node> beam;						// The boards of the current layer
+	std::vector<std::vector<Node>> children;	// The boards of the next layer, per task
+	std::vector<long long> expanded;			// # of children evaluated per task, dropped copies included
+	std::vector<TetShape> shapes;				// The shapes placed by each layer
+	int layer{ 0 };								// Layer being expanded
+	int taskCount{ 0 };							// # of tasks the layer is split into
+	ThreadPool::Job expandTask;					// Expands a task's share of the beam, made once so running it doesn't allocate
+	Stats stats;
+
+public:
+	// Constructors
+	// @param config: Beam width, lookahead & threads.
+	BeamSearchPolicy() : BeamSearchPolicy(Config()) {}
+	explicit BeamSearchPolicy(const Config& config);
+
+	Placement choosePlacement(const TetrisEngine& engine) override;
+
+	const Stats& getStats() const { return stats; }
+	const Config& getConfig() const { return config; }
+
+private:
+	// Place the layer's shape on every board of the beam, then keep the best children as the new beam.
+	// @return: The # of children evaluated; the beam is left alone if there are none.
+	long long expandLayer();
+
+	// Check whether a board is among the first boards of the beam.
+	// @param hash: Hash of the board.
+	// @param kept: # of boards of the beam to look at.
+	bool isKept(std::uint64_t hash, int kept) const;
+
+	// Place the layer's shape on a task's share of the beam, adding the children to children[task].
+	void expandNodes(int task, Worker& worker);
+};
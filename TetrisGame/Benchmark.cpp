@@ -0,0 +1,309 @@
+#include "Benchmark.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include "MoveGenerator.h"
+#include "BeamSearch.h"
+#include "Randomizer.h"
+#include "SelfPlay.h"
+#include "TetrisEngine.h"
+#include "TranspositionTable.h"
+
+namespace {
+	std::atomic<std::size_t> allocationCount{ 0 };
+
+	volatile int sink;	// Results of the timed operations go here so they aren't optimized away.
+
+	const int CLEARED_ROWS = 4;	// Rows completed on the boards used to time row clearing.
+
+	// Fill a row except for its holes.
+	template<typename Board>
+	void fillRowExcept(Board& board, int y, typename Board::RowMask holes, Pcg32& rng) {
+		for (int x = 0; x < Board::MAX_X; x++) {
+			if (!(holes & Board::getColumnBit(x))) {
+				board.setContent(x, y, static_cast<int>(rng.nextBelow(static_cast<int>(TetColor::COUNT))));
+			}
+		}
+	}
+
+	// Complete the bottom rows of a board.
+	template<typename Board>
+	Board withCompletedRows(Board board) {
+		Pcg32 rng;
+		for (int y = Board::MAX_Y - CLEARED_ROWS; y < Board::MAX_Y; y++) {
+			fillRowExcept(board, y, 0, rng);
+		}
+		return board;
+	}
+
+	// Build a board of any size for a fill, see Benchmark::makeBoard().
+	template<typename Board>
+	Board makeBoardOfSize(Benchmark::BoardFill fill, std::uint64_t seed) {
+		Board board;
+		Pcg32 rng;
+		rng.seed(seed, 4);
+		int rows{ 0 };
+		switch (fill) {
+			case Benchmark::BoardFill::Empty:    rows = 0; break;
+			case Benchmark::BoardFill::HalfFull: rows = Board::MAX_Y / 2; break;
+			case Benchmark::BoardFill::Garbage:  rows = Board::MAX_Y - 4; break;
+			default: break;
+		}
+
+		for (int y = Board::MAX_Y - rows; y < Board::MAX_Y; y++) {
+			typename Board::RowMask holes = Board::getColumnBit(rng.nextBelow(Board::MAX_X));
+			if (fill == Benchmark::BoardFill::HalfFull && rng.nextBelow(2)) {
+				holes |= Board::getColumnBit(rng.nextBelow(Board::MAX_X));
+			}
+			fillRowExcept(board, y, holes, rng);
+		}
+		return board;
+	}
+
+	// Turn a board into one where column 0 is empty and the bottom rows are completed except
+	// for column 0, so a vertical I dropped in column 0 clears CLEARED_ROWS rows.
+	Gameboard makeTetrisReadyBoard(Gameboard board) {
+		Pcg32 rng;
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			board.setContent(0, y, Gameboard::EMPTY_BLOCK);
+		}
+		for (int y = Gameboard::MAX_Y - CLEARED_ROWS; y < Gameboard::MAX_Y; y++) {
+			fillRowExcept(board, y, 1, rng);
+		}
+		return board;
+	}
+
+	// A vertical I whose blocks are all in column 0.
+	GridTetromino makeVerticalI() {
+		GridTetromino shape;
+		shape.setShape(TetShape::I);
+		for (int orientation = 0; orientation < Tetromino::ORIENTATION_COUNT; orientation++) {
+			shape.setOrientation(orientation);
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				shape.setGridLoc(x, 1);
+				bool inColumn0{ true };
+				for (const Point& p : shape.getBlockLocsMappedToGrid()) {
+					inColumn0 = inColumn0 && p.getX() == 0;
+				}
+				if (inColumn0) {
+					return shape;
+				}
+			}
+		}
+		assert(false && "No vertical I orientation");
+		return shape;
+	}
+}
+
+#ifdef TETRIS_BENCH
+// Count every heap allocation made by the program, for allocs/op.
+void* operator new(std::size_t size) {
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+#endif
+
+// STATIC CONSTANTS ======================================
+
+#ifdef TETRIS_BENCH
+const bool Benchmark::COUNTS_ALLOCATIONS = true;
+#else
+const bool Benchmark::COUNTS_ALLOCATIONS = false;
+#endif
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+std::vector<Benchmark::Result> Benchmark::runAll() const {
+	std::vector<Result> results;
+	for (int f = 0; f < static_cast<int>(BoardFill::COUNT); f++) {
+		BoardFill fill{ static_cast<BoardFill>(f) };
+		const Gameboard board = makeBoard(fill);
+		const Gameboard completed = withCompletedRows(board);
+
+		TetrisEngine engine(1);
+		setEngineState(engine, board, engine.getCurrentShape());
+		const GridTetromino ghost = engine.getGhostShape();
+		GridTetromino::BlockLocs ghostLocs = ghost.getBlockLocsMappedToGrid();
+		const std::vector<Point> locs(ghostLocs.begin(), ghostLocs.end());
+		TetrisEngine tetrisReady(1);
+		setEngineState(tetrisReady, makeTetrisReadyBoard(board), makeVerticalI());
+
+		results.push_back(measure("Gameboard::areAllLocsEmpty", fill, [&]() {
+			sink += board.areAllLocsEmpty(locs);
+		}));
+		results.push_back(measure("Gameboard::getCompletedRowIndices(4 rows)", fill, [&]() {
+			sink += static_cast<int>(completed.getCompletedRowIndices().size());
+		}));
+		results.push_back(measure("Gameboard copy", fill, [&]() {
+			Gameboard copy = completed;
+			sink += copy.getRowMask(Gameboard::MAX_Y - 1);
+		}));
+		results.push_back(measure("Gameboard::removeCompletedRows(4 rows)", fill, [&]() {
+			Gameboard copy = completed;
+			sink += copy.removeCompletedRows();
+		}));
+		results.push_back(measure("GridTetromino::getBlockLocsMappedToGrid", fill, [&]() {
+			sink += ghost.getBlockLocsMappedToGrid()[0].getX();
+		}));
+		int dx{ 1 };
+		results.push_back(measure("TetrisEngine::attemptMove", fill, [&]() {
+			sink += engine.attemptMove(engine.currentShape, dx, 0);
+			dx = -dx;
+		}));
+		results.push_back(measure("TetrisEngine::attemptRotate", fill, [&]() {
+			sink += engine.attemptRotate(engine.currentShape);
+		}));
+		results.push_back(measure("TetrisEngine::drop", fill, [&]() {
+			GridTetromino shape = engine.currentShape;
+			engine.drop(shape);
+			sink += shape.getGridLoc().getY();
+		}));
+		results.push_back(measure("TetrisEngine lock+clear(4 rows)", fill, [&]() {
+			TetrisEngine copy = tetrisReady;
+			copy.handleInput(GameInput::HardDrop);
+			copy.step(0.0);
+			sink += copy.getScore();
+		}));
+		const BitBoard<Gameboard::MAX_X, Gameboard::MAX_Y> bits(board);
+		MoveGenerator<Gameboard::MAX_X, Gameboard::MAX_Y> generator;
+		std::vector<Placement> placements;
+		int shape{ 0 };
+		results.push_back(measure("MoveGenerator::generate(hard drops)", fill, [&]() {
+			generator.generate(bits, static_cast<TetShape>(shape), placements, false);
+			shape = (shape + 1) % static_cast<int>(TetShape::COUNT);
+			sink += static_cast<int>(placements.size());
+		}));
+		results.push_back(measure("MoveGenerator::generate(with tucks)", fill, [&]() {
+			generator.generate(bits, static_cast<TetShape>(shape), placements, true);
+			shape = (shape + 1) % static_cast<int>(TetShape::COUNT);
+			sink += static_cast<int>(placements.size());
+		}));
+		const BoardFeatures<Gameboard::MAX_X, Gameboard::MAX_Y> features(bits);
+		results.push_back(measure("BoardFeatures::compute", fill, [&]() {
+			BoardFeatures<Gameboard::MAX_X, Gameboard::MAX_Y> computed(bits);
+			sink += computed.getHoles();
+		}));
+		generator.generate(bits, engine.getCurrentShape().getShape(), placements, false);
+		std::size_t next{ 0 };
+		results.push_back(measure("BoardFeatures::place(incremental)", fill, [&]() {
+			const Placement& placement = placements[next++ % placements.size()];
+			BitBoard<Gameboard::MAX_X, Gameboard::MAX_Y> child = bits;
+			BoardFeatures<Gameboard::MAX_X, Gameboard::MAX_Y> childFeatures = features;
+			childFeatures.place(child, PieceMask::get(engine.getCurrentShape().getShape(), placement.orientation), placement.x, placement.y);
+			sink += childFeatures.getHoles();
+		}));
+		HeuristicPolicy policy;
+		results.push_back(measure("HeuristicPolicy::choosePlacement", fill, [&]() {
+			sink += policy.choosePlacement(engine).x;
+		}));
+		TranspositionTable table(BeamSearchPolicy::Config().tableBits);
+		std::uint64_t key{ bits.getHash() };
+		results.push_back(measure("TranspositionTable::store", fill, [&]() {
+			key = key * 6364136223846793005ull + 1442695040888963407ull;
+			sink += table.store(key, static_cast<float>(key & 0xFF)) > 0;
+		}));
+		BeamSearchPolicy::Config beamConfig;
+		beamConfig.depth = 3;
+		BeamSearchPolicy beamSearch(beamConfig);
+		results.push_back(measure("BeamSearchPolicy::choosePlacement(beam 32, 3 shapes)", fill, [&]() {
+			sink += beamSearch.choosePlacement(engine).x;
+		}));
+		measureBoardSize<32, 64>(results, fill);
+		measureBoardSize<40, 100>(results, fill);
+	}
+	return results;
+}
+
+void Benchmark::printCsv(std::ostream& out, const std::vector<Result>& results) {
+	out << "name,fill,iterations,ns_per_op,allocs_per_op\n";
+	for (const Result& r : results) {
+		out << r.name << ',' << getFillName(r.fill) << ',' << r.iterations << ',' << r.nsPerOp << ',';
+		if (COUNTS_ALLOCATIONS) {
+			out << r.allocsPerOp;
+		}
+		out << '\n';
+	}
+}
+
+Gameboard Benchmark::makeBoard(BoardFill fill, std::uint64_t seed) {
+	return makeBoardOfSize<Gameboard>(fill, seed);
+}
+
+const char* Benchmark::getFillName(BoardFill fill) {
+	switch (fill) {
+		case BoardFill::Empty:    return "empty";
+		case BoardFill::HalfFull: return "half-full";
+		case BoardFill::Garbage:  return "garbage";
+		default:                  return "?";
+	}
+}
+
+std::size_t Benchmark::getAllocationCount() {
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+// PRIVATE METHODS ---------------------------------------
+
+void Benchmark::setEngineState(TetrisEngine& engine, const Gameboard& board, const GridTetromino& currentShape) {
+	engine.board = board;
+	engine.currentShape = currentShape;
+	engine.ghostShapeDirty = true;
+}
+
+template<int Width, int Height>
+void Benchmark::measureBoardSize(std::vector<Result>& results, BoardFill fill) const {
+	typedef BasicGameboard<Width, Height> Board;
+	const std::string size{ "<" + std::to_string(Width) + "x" + std::to_string(Height) + ">" };
+	const Board completed = withCompletedRows(makeBoardOfSize<Board>(fill, 1));
+	BasicTetrisEngine<Width, Height> engine(1);
+	engine.board = makeBoardOfSize<Board>(fill, 1);
+	engine.ghostShapeDirty = true;
+
+	results.push_back(measure(("Gameboard" + size + "::removeCompletedRows(4 rows)").c_str(), fill, [&]() {
+		Board copy = completed;
+		sink += copy.removeCompletedRows();
+	}));
+	results.push_back(measure(("TetrisEngine" + size + "::drop").c_str(), fill, [&]() {
+		GridTetromino shape = engine.currentShape;
+		engine.drop(shape);
+		sink += shape.getGridLoc().getY();
+	}));
+}
+
+template <typename Op>
+Benchmark::Result Benchmark::measure(const char* name, BoardFill fill, Op op) const {
+	for (int i = 0; i < 16; i++) {
+		op();	// warm up
+	}
+
+	Result result;
+	result.name = name;
+	result.fill = fill;
+	std::size_t allocsBefore{ getAllocationCount() };
+	auto start = std::chrono::steady_clock::now();
+	std::chrono::duration<double> elapsed;
+	long long batch{ 64 };
+	do {
+		for (long long i = 0; i < batch; i++) {
+			op();
+		}
+		result.iterations += batch;
+		batch *= 2;
+		elapsed = std::chrono::steady_clock::now() - start;
+	} while (elapsed.count() < minSeconds);
+	result.nsPerOp = elapsed.count() * 1e9 / result.iterations;
+	result.allocsPerOp = static_cast<double>(getAllocationCount() - allocsBefore) / result.iterations;
+	return result;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Gameboard.h"
+#include "TetrisEngine.h"
+
+/*
+ * The Benchmark class times the engine's hot paths (collision checks, drops, row clearing, move
+ * generation, a full lock & clear cycle) on a few representative boards, plus the size dependent
+ * ones on wider boards, and reports ns/op & heap allocations/op as CSV so runs of different
+ * implementations can be diffed or plotted.
+ * Allocations are counted by the global operator new replaced in Benchmark.cpp, which is only
+ * compiled in when TETRIS_BENCH is defined (the Bench configuration), so the game's own
+ * allocations don't pay for the counting. Without it allocs/op is left blank.
+ */
+class Benchmark {
+	friend class TestSuite;
+
+public:
+	static const bool COUNTS_ALLOCATIONS;	// True if operator new is replaced & allocations counted
+
+	// Board contents the operations are measured on.
+	enum class BoardFill {
+		Empty,		// Nothing placed yet.
+		HalfFull,	// Bottom half filled, one or two holes per row.
+		Garbage,	// All but the top 4 rows of garbage, one hole per row.
+		COUNT
+	};
+
+	struct Result {
+		std::string name;			// Operation measured.
+		BoardFill fill;				// Board it was measured on.
+		long long iterations{ 0 };	// # of operations timed.
+		double nsPerOp{ 0 };
+		double allocsPerOp{ 0 };
+	};
+
+private:
+	double minSeconds;	// Minimum time spent timing each operation.
+
+public:
+	// Constructor
+	// @param minSeconds: Minimum time spent timing each operation; more is steadier.
+	explicit Benchmark(double minSeconds = 0.25) : minSeconds(minSeconds) {}
+
+	// Time every operation on every board fill.
+	// @return: One result per operation & fill.
+	std::vector<Result> runAll() const;
+
+	// Write results as CSV with a header line.
+	// @param out: Where to write.
+	// @param results: Results of runAll().
+	static void printCsv(std::ostream& out, const std::vector<Result>& results);
+
+	// Build a board for a fill. The same fill & seed always give the same board.
+	// @param fill: What the board should look like.
+	// @param seed: Seed of the hole positions.
+	// @return: A board without completed rows.
+	static Gameboard makeBoard(BoardFill fill, std::uint64_t seed = 1);
+
+	// @return: The name of a fill, as printed in the CSV.
+	static const char* getFillName(BoardFill fill);
+
+	// @return: The # of calls to the global operator new since the program started, 0 without TETRIS_BENCH.
+	static std::size_t getAllocationCount();
+
+private:
+	// Replace the board & current shape of an engine.
+	// @param engine: The engine to set up.
+	// @param board: Its new board.
+	// @param currentShape: Its new current shape.
+	static void setEngineState(TetrisEngine& engine, const Gameboard& board, const GridTetromino& currentShape);
+
+	// Time the operations whose cost grows with the board on a board of another size, so the
+	// standard board's rows can be compared against wider masks & taller boards.
+	// @param results: Where to add the results.
+	// @param fill: Board fill the operations run on.
+	template<int Width, int Height>
+	void measureBoardSize(std::vector<Result>& results, BoardFill fill) const;
+
+	// Time an operation, repeating it in growing batches until minSeconds have passed.
+	// @param name: Name of the operation.
+	// @param fill: Board fill the operation runs on.
+	// @param op: The operation, called once per iteration.
+	// @return: The measurement.
+	template <typename Op>
+	Result measure(const char* name, BoardFill fill, Op op) const;
+};
@@ -0,0 +1,154 @@
+#include "BitBoard.h"
+#include <algorithm>
+#include <array>
+
+namespace {
+	typedef std::array<std::array<PieceMask, Tetromino::ORIENTATION_COUNT>, static_cast<int>(TetShape::COUNT)> PieceMaskTable;
+
+	// Build the mask of every shape & orientation from Tetromino's block table.
+	PieceMaskTable buildPieceMasks() {
+		PieceMaskTable table;
+		for (int s = 0; s < static_cast<int>(TetShape::COUNT); s++) {
+			for (int o = 0; o < Tetromino::ORIENTATION_COUNT; o++) {
+				const Tetromino::BlockLocs& blocks = Tetromino::getBlockLocs(static_cast<TetShape>(s), o);
+				PieceMask& piece = table[s][o];
+				int minX{ 0 }, maxX{ 0 }, minY{ 0 }, maxY{ 0 };
+				for (const Point& p : blocks) {
+					minX = std::min(minX, p.getX());
+					maxX = std::max(maxX, p.getX());
+					minY = std::min(minY, p.getY());
+					maxY = std::max(maxY, p.getY());
+				}
+				piece.minX = static_cast<std::int8_t>(minX);
+				piece.maxX = static_cast<std::int8_t>(maxX);
+				piece.minY = static_cast<std::int8_t>(minY);
+				piece.maxY = static_cast<std::int8_t>(maxY);
+				piece.width = maxX - minX + 1;
+				piece.height = maxY - minY + 1;
+				for (int i = 0; i < Tetromino::BLOCK_COUNT; i++) {
+					piece.rows[i] = 0;
+					piece.bottoms[i] = INT8_MIN;
+				}
+				for (const Point& p : blocks) {
+					piece.rows[p.getY() - minY] |= static_cast<std::uint8_t>(1 << (p.getX() - minX));
+					std::int8_t& bottom = piece.bottoms[p.getX() - minX];
+					bottom = std::max(bottom, static_cast<std::int8_t>(p.getY()));
+				}
+
+				// The first orientation with the same footprint is canonical.
+				piece.canonicalOrientation = static_cast<std::uint8_t>(o);
+				piece.canonicalDx = 0;
+				piece.canonicalDy = 0;
+				for (int c = 0; c < o; c++) {
+					const PieceMask& other = table[s][c];
+					if (other.height == piece.height && std::equal(piece.rows, piece.rows + piece.height, other.rows)) {
+						piece.canonicalOrientation = static_cast<std::uint8_t>(c);
+						piece.canonicalDx = static_cast<std::int8_t>(piece.minX - other.minX);
+						piece.canonicalDy = static_cast<std::int8_t>(piece.minY - other.minY);
+						break;
+					}
+				}
+			}
+		}
+		return table;
+	}
+
+	const PieceMaskTable PIECE_MASKS = buildPieceMasks();
+}
+
+// -------------- PIECE MASK -------------- //
+
+const PieceMask& PieceMask::get(TetShape shape, int orientation) {
+	return PIECE_MASKS[static_cast<int>(shape)][orientation];
+}
+
+// -------------- BIT BOARD -------------- //
+
+template<int Width, int Height>
+BitBoard<Width, Height>::BitBoard(const Board& board)
+	: hash(board.getHash())
+{
+	for (int y = 0; y < Height; y++)
+		rows[y] = board.getRowMask(y);
+}
+
+template<int Width, int Height>
+void BitBoard<Width, Height>::setRowMask(int rowIdx, RowMask mask) {
+	mask &= Board::FULL_ROW_MASK;
+	hash ^= ZobristKeys<Width, Height>::get().getRowKey(rowIdx, rows[rowIdx] ^ mask);
+	rows[rowIdx] = mask;
+}
+
+template<int Width, int Height>
+int BitBoard<Width, Height>::getDropY(const PieceMask& piece, int x, int y) const {
+	while (fits(piece, x, y + 1))
+		y++;
+	return y;
+}
+
+template<int Width, int Height>
+int BitBoard<Width, Height>::place(const PieceMask& piece, int x, int y) {
+	const ZobristKeys<Width, Height>& keys = ZobristKeys<Width, Height>::get();
+	int left{ x + piece.minX };
+	for (int r = 0; r < piece.height; r++) {
+		int rowIdx{ y + piece.minY + r };
+		if (rowIdx < 0)
+			continue;
+		rows[rowIdx] |= static_cast<RowMask>(RowMask(piece.rows[r]) << left);
+		for (int c = 0; c < piece.width; c++) {
+			if (piece.rows[r] & (1 << c))
+				hash ^= keys.getCellKey(left + c, rowIdx);
+		}
+	}
+
+	// Only the shape's rows can have been completed.
+	return removeCompletedRows(std::max(y + piece.minY, 0), std::min(y + piece.maxY, Height - 1));
+}
+
+template<int Width, int Height>
+int BitBoard<Width, Height>::removeCompletedRows(int top, int bottom) {
+	bool completed{ false };
+	for (int rowIdx = top; rowIdx <= bottom; rowIdx++)
+		completed = completed || rows[rowIdx] == Board::FULL_ROW_MASK;
+	if (!completed)
+		return 0;
+
+	// Compact bottom-up from the lowest row that may be completed.
+	int dst{ bottom };
+	for (int src = bottom; src >= 0; src--) {
+		if (src >= top && rows[src] == Board::FULL_ROW_MASK)
+			continue;
+		rows[dst--] = rows[src];
+	}
+	int removed{ dst + 1 };
+	for (; dst >= 0; dst--)
+		rows[dst] = 0;
+
+	// Every row down to the lowest removed one has moved.
+	const ZobristKeys<Width, Height>& keys = ZobristKeys<Width, Height>::get();
+	hash = 0;
+	for (int rowIdx = 0; rowIdx < Height; rowIdx++)
+		hash ^= keys.getRowKey(rowIdx, rows[rowIdx]);
+	return removed;
+}
+
+template<int Width, int Height>
+void BitBoard<Width, Height>::getColumnTops(int* tops) const {
+	RowMask seen{ 0 };
+	for (int x = 0; x < Width; x++)
+		tops[x] = Height;
+	for (int y = 0; y < Height && seen != Board::FULL_ROW_MASK; y++) {
+		RowMask newlySeen = static_cast<RowMask>(rows[y] & ~seen);
+		for (int x = 0; newlySeen != 0; x++, newlySeen >>= 1) {
+			if (newlySeen & 1)
+				tops[x] = y;
+		}
+		seen |= rows[y];
+	}
+}
+
+// EXPLICIT INSTANTIATIONS -------------------------------
+
+template class BitBoard<10, 19>;
+template class BitBoard<32, 64>;
+template class BitBoard<40, 100>;
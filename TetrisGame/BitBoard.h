@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include "Gameboard.h"
+#include "Tetromino.h"
+
+/*
+ * The footprint of a shape in one orientation as row masks, precomputed for every shape &
+ * orientation so placing or testing a shape is a handful of shifts & ANDs.
+ */
+struct PieceMask {
+	std::int8_t minX, maxX, minY, maxY;				// Bounding box of the blocks, relative to the origin
+	std::uint8_t rows[Tetromino::BLOCK_COUNT];		// Bit c of rows[r]: a block at (minX + c, minY + r)
+	std::int8_t bottoms[Tetromino::BLOCK_COUNT];	// Lowest block of column minX + c, relative to the origin
+	int width;										// # of columns, maxX - minX + 1
+	int height;										// # of rows, maxY - minY + 1
+
+	// Orientations covering the same cells (e.g. O in any orientation, S & Z & I turned twice) share
+	// a canonical orientation: this orientation at (x, y) covers the same cells as the canonical
+	// one at (x + canonicalDx, y + canonicalDy).
+	std::uint8_t canonicalOrientation;
+	std::int8_t canonicalDx, canonicalDy;
+
+	// Get the mask of a shape in an orientation.
+	static const PieceMask& get(TetShape shape, int orientation);
+};
+
+/*
+ * The BitBoard class template is the occupancy of a board without its colors: one row mask per
+ * row, as in BasicGameboard. It is cheap to copy and to place shapes on, which is what searches
+ * over many possible placements (move generation, bots) need. Rows above the board are empty,
+ * as in the engine. It keeps the same Zobrist hash as BasicGameboard, so searches can spot boards
+ * they have already seen. Members are explicitly instantiated in BitBoard.cpp for the sizes listed there.
+ */
+template<int Width, int Height>
+class BitBoard {
+	friend class TestSuite;
+
+public:
+	typedef BasicGameboard<Width, Height> Board;
+	typedef typename Board::RowMask RowMask;
+
+private:
+	RowMask rows[Height];
+	std::uint64_t hash;		// Zobrist hash of the rows
+
+public:
+	// Constructors
+	BitBoard() : rows(), hash(0) {}
+	explicit BitBoard(const Board& board);
+
+	RowMask getRowMask(int rowIdx) const { return rows[rowIdx]; }
+	void setRowMask(int rowIdx, RowMask mask);
+
+	// Fill one cell.
+	void setCell(int x, int y) {
+		if (!(rows[y] & Board::getColumnBit(x))) {
+			rows[y] |= Board::getColumnBit(x);
+			hash ^= ZobristKeys<Width, Height>::get().getCellKey(x, y);
+		}
+	}
+
+	// Get the Zobrist hash of the filled cells, equal to BasicGameboard::getHash() for the same cells.
+	std::uint64_t getHash() const { return hash; }
+
+	// Determine if a shape fits at a position: within the left, right & bottom borders and
+	// not overlapping any block.
+	// @param piece: The shape & orientation.
+	// @param x, y: Grid location of the shape's origin.
+	bool fits(const PieceMask& piece, int x, int y) const {
+		int left{ x + piece.minX };
+		if (left < 0 || x + piece.maxX >= Width || y + piece.maxY >= Height)
+			return false;
+		for (int r = 0; r < piece.height; r++) {
+			int rowIdx{ y + piece.minY + r };
+			if (rowIdx >= 0 && (rows[rowIdx] & static_cast<RowMask>(RowMask(piece.rows[r]) << left)))
+				return false;
+		}
+		return true;
+	}
+
+	// Get where a shape comes to rest when dropped straight down from a position it fits at.
+	// @return: The grid y of the shape's origin at rest.
+	int getDropY(const PieceMask& piece, int x, int y) const;
+
+	// Lock a shape into the board and remove the rows it completes.
+	// @param piece: The shape & orientation.
+	// @param x, y: Grid location of the shape's origin, where it fits.
+	// @return: The number of rows removed.
+	int place(const PieceMask& piece, int x, int y);
+
+	// Remove the completed rows within a range of rows, moving the rows above them down.
+	// @param top, bottom: The range, the only rows that may be completed.
+	// @return: The number of rows removed.
+	int removeCompletedRows(int top, int bottom);
+
+	// Get the skyline: the row of the highest block of every column, Height if empty.
+	// @param tops: Receives Width values.
+	void getColumnTops(int* tops) const;
+};
@@ -0,0 +1,76 @@
+#include "BlockBatch.h"
+#include "TetrisRenderer.h"
+
+// CONSTRUCTOR -------------------------------------------
+
+BlockBatch::BlockBatch(const sf::Texture& texture, int slotCount)
+	: vertices(sf::Quads, slotCount * 4), texture(texture), slots(slotCount)
+{
+	// Every slot starts as an empty, degenerate quad.
+}
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+void BlockBatch::setSlot(int slotIdx, const Point& topLeft, int x, int y, int content, sf::Uint8 alpha) {
+	Slot& slot = slots[slotIdx];
+	int xPos = topLeft.getX() + (x * TetrisRenderer::BLOCK_WIDTH);
+	int yPos = topLeft.getY() + (y * TetrisRenderer::BLOCK_HEIGHT);
+	if (slot.content == content && (content == Gameboard::EMPTY_BLOCK ||
+		(slot.xPos == xPos && slot.yPos == yPos && slot.alpha == alpha))) {
+		return;
+	}
+	slot.xPos = xPos;
+	slot.yPos = yPos;
+	slot.content = content;
+	slot.alpha = alpha;
+
+	sf::Vertex* quad = &vertices[slotIdx * 4];
+	if (content == Gameboard::EMPTY_BLOCK) {
+		for (int i = 0; i < 4; i++) {
+			quad[i].position = sf::Vector2f(0.f, 0.f);	// degenerate, nothing is rasterized
+		}
+		return;
+	}
+
+	float left = static_cast<float>(xPos);
+	float top = static_cast<float>(yPos);
+	float right = left + TetrisRenderer::BLOCK_WIDTH;
+	float bottom = top + TetrisRenderer::BLOCK_HEIGHT;
+	float texLeft = static_cast<float>(content * TetrisRenderer::BLOCK_WIDTH);
+	float texRight = texLeft + TetrisRenderer::BLOCK_WIDTH;
+	float texBottom = static_cast<float>(TetrisRenderer::BLOCK_HEIGHT);
+
+	quad[0].position = sf::Vector2f(left, top);
+	quad[1].position = sf::Vector2f(right, top);
+	quad[2].position = sf::Vector2f(right, bottom);
+	quad[3].position = sf::Vector2f(left, bottom);
+	quad[0].texCoords = sf::Vector2f(texLeft, 0.f);
+	quad[1].texCoords = sf::Vector2f(texRight, 0.f);
+	quad[2].texCoords = sf::Vector2f(texRight, texBottom);
+	quad[3].texCoords = sf::Vector2f(texLeft, texBottom);
+	for (int i = 0; i < 4; i++) {
+		quad[i].color = sf::Color(255, 255, 255, alpha);
+	}
+}
+
+void BlockBatch::setBoardSlots(int firstSlot, const Gameboard& board, const Point& topLeft) {
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			setSlot(firstSlot + y * Gameboard::MAX_X + x, topLeft, x, y, board.getContent(x, y), 255);
+		}
+	}
+}
+
+void BlockBatch::setShapeSlots(int firstSlot, const GridTetromino& shape, const Point& topLeft, sf::Uint8 alpha) {
+	int slotIdx = firstSlot;
+	for (const Point& blockLoc : shape.getBlockLocsMappedToGrid()) {
+		setSlot(slotIdx++, topLeft, blockLoc.getX(), blockLoc.getY(), static_cast<int>(shape.getColor()), alpha);
+	}
+}
+
+// PRIVATE METHODS ---------------------------------------
+
+void BlockBatch::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+	states.texture = &texture;
+	target.draw(vertices, states);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "Gameboard.h"
+#include "GridTetromino.h"
+
+/*
+ * The BlockBatch class draws a fixed number of tetris blocks as textured quads of a single
+ * sf::VertexArray, so they cost one draw call. Each block has a slot of 4 vertices; a slot's
+ * quad is only rewritten when its position, color or alpha changed since it was last set.
+ */
+class BlockBatch : public sf::Drawable {
+public:
+	static const sf::Uint8 GHOST_ALPHA = 100;	// Alpha of the ghost shape's blocks
+
+private:
+	// What a slot currently shows.
+	struct Slot {
+		int xPos{ 0 };					// Pixel x of the block's top left.
+		int yPos{ 0 };					// Pixel y of the block's top left.
+		int content{ Gameboard::EMPTY_BLOCK };	// TetColor of the block, or EMPTY_BLOCK for no quad.
+		sf::Uint8 alpha{ 255 };
+	};
+
+	sf::VertexArray vertices;		// 4 vertices per slot, sf::Quads.
+	const sf::Texture& texture;		// Tile sheet, one BLOCK_WIDTH column per TetColor.
+	std::vector<Slot> slots;
+
+public:
+	// Constructor
+	// @param texture: The tile sheet used for all blocks, must outlive the batch.
+	// @param slotCount: The # of blocks the batch can show.
+	BlockBatch(const sf::Texture& texture, int slotCount);
+
+	// Point a slot at a block, rewriting its quad if it changed.
+	// @param slotIdx: The slot to set.
+	// @param topLeft: Top left of the area the block is offset into, in pixels.
+	// @param x: The x-offset of the block in blocks.
+	// @param y: The y-offset of the block in blocks.
+	// @param content: The TetColor of the block, or EMPTY_BLOCK to hide the slot.
+	// @param alpha: The alpha of the block.
+	void setSlot(int slotIdx, const Point& topLeft, int x, int y, int content, sf::Uint8 alpha);
+
+	// Point MAX_X * MAX_Y slots at the cells of a board, row by row.
+	// @param firstSlot: The first of the board's slots.
+	// @param board: The board to show.
+	// @param topLeft: Top left of the board, in pixels.
+	void setBoardSlots(int firstSlot, const Gameboard& board, const Point& topLeft);
+
+	// Point BLOCK_COUNT slots at the blocks of a shape.
+	// @param firstSlot: The first of the shape's slots.
+	// @param shape: The shape to show.
+	// @param topLeft: Top left of the area the shape is offset into, in pixels.
+	// @param alpha: The alpha of the shape's blocks.
+	void setShapeSlots(int firstSlot, const GridTetromino& shape, const Point& topLeft, sf::Uint8 alpha);
+
+private:
+	// Draw every slot with one draw call.
+	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
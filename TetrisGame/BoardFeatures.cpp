@@ -0,0 +1,138 @@
+#include "BoardFeatures.h"
+#include <algorithm>
+#include <bitset>
+#include <cstdlib>
+
+namespace {
+	int popcount(std::uint64_t bits) {
+		return static_cast<int>(std::bitset<64>(bits).count());
+	}
+}
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+template<int Width, int Height>
+void BoardFeatures<Width, Height>::compute(const Board& board) {
+	static_assert(Width <= 62, "Row transitions are counted in 64 bits, walls included");
+	const std::uint64_t walls{ 1 | (std::uint64_t(1) << (Width + 1)) };
+	const std::uint64_t fullRow{ BasicGameboard<Width, Height>::FULL_ROW_MASK };
+
+	RowMask covered{ 0 };	// Columns with a block in a row above
+	RowMask above{ 0 };		// The row above, empty above the board
+	holes = 0;
+	rowTransitions = 0;
+	columnTransitions = 0;
+	for (int x = 0; x < Width; x++)
+		tops[x] = static_cast<std::int8_t>(Height);
+
+	for (int y = 0; y < Height; y++) {
+		RowMask row{ board.getRowMask(y) };
+		RowMask newlyCovered = static_cast<RowMask>(row & ~covered);
+		for (int x = 0; newlyCovered != 0; x++, newlyCovered >>= 1) {
+			if (newlyCovered & 1)
+				tops[x] = static_cast<std::int8_t>(y);
+		}
+		holes += popcount(covered & ~row);
+		columnTransitions += popcount(above ^ row);
+
+		std::uint64_t walled{ (std::uint64_t(row) << 1) | walls };
+		rowTransitions += popcount((walled ^ (walled >> 1)) & ((fullRow << 1) | 1));
+		covered |= row;
+		above = row;
+	}
+	columnTransitions += popcount(fullRow & ~std::uint64_t(above));	// against the floor
+	linesCleared = 0;
+}
+
+template<int Width, int Height>
+int BoardFeatures<Width, Height>::place(Board& board, const PieceMask& piece, int x, int y) {
+	// Add the cells one at a time, bottom-up, so every cell sees the ones below it already placed.
+	for (int r = piece.height - 1; r >= 0; r--) {
+		int rowIdx{ y + piece.minY + r };
+		if (rowIdx < 0)
+			continue;
+		for (int c = 0; c < piece.width; c++) {
+			if (!(piece.rows[r] & (1 << c)))
+				continue;
+			int column{ x + piece.minX + c };
+
+			// Each neighbour changes a transition: one filled side removes it, an empty one adds it.
+			rowTransitions += (isFilled(board, column - 1, rowIdx) ? -1 : 1) + (isFilled(board, column + 1, rowIdx) ? -1 : 1);
+			columnTransitions += (isFilled(board, column, rowIdx - 1) ? -1 : 1) + (isFilled(board, column, rowIdx + 1) ? -1 : 1);
+
+			// A cell under the column top fills a hole, one above it covers the empty cells in between.
+			if (rowIdx > tops[column]) {
+				holes--;
+			}
+			else {
+				holes += tops[column] - rowIdx - 1;
+				tops[column] = static_cast<std::int8_t>(rowIdx);
+			}
+			board.setCell(column, rowIdx);
+		}
+	}
+
+	int removed{ board.removeCompletedRows(std::max(y + piece.minY, 0), std::min(y + piece.maxY, Height - 1)) };
+	if (removed > 0) {
+		compute(board);
+	}
+	linesCleared = removed;
+	return removed;
+}
+
+template<int Width, int Height>
+double BoardFeatures<Width, Height>::evaluate(const EvaluationWeights& weights) const {
+	return weights.aggregateHeight * getAggregateHeight()
+		+ weights.holes * holes
+		+ weights.bumpiness * getBumpiness()
+		+ weights.wells * getWells()
+		+ weights.rowTransitions * rowTransitions
+		+ weights.columnTransitions * columnTransitions
+		+ weights.linesCleared * linesCleared;
+}
+
+template<int Width, int Height>
+int BoardFeatures<Width, Height>::getAggregateHeight() const {
+	int sum{ 0 };
+	for (int x = 0; x < Width; x++)
+		sum += Height - tops[x];
+	return sum;
+}
+
+template<int Width, int Height>
+int BoardFeatures<Width, Height>::getBumpiness() const {
+	int sum{ 0 };
+	for (int x = 1; x < Width; x++)
+		sum += std::abs(tops[x] - tops[x - 1]);
+	return sum;
+}
+
+template<int Width, int Height>
+int BoardFeatures<Width, Height>::getWells() const {
+	int sum{ 0 };
+	for (int x = 0; x < Width; x++) {
+		int left{ x > 0 ? tops[x - 1] : 0 };
+		int right{ x < Width - 1 ? tops[x + 1] : 0 };
+		int depth{ tops[x] - std::max(left, right) };
+		if (depth > 0)
+			sum += depth * (depth + 1) / 2;
+	}
+	return sum;
+}
+
+// PRIVATE METHODS ---------------------------------------
+
+template<int Width, int Height>
+bool BoardFeatures<Width, Height>::isFilled(const Board& board, int x, int y) {
+	if (x < 0 || x >= Width || y >= Height)
+		return true;
+	if (y < 0)
+		return false;
+	return (board.getRowMask(y) & BasicGameboard<Width, Height>::getColumnBit(x)) != 0;
+}
+
+// EXPLICIT INSTANTIATIONS -------------------------------
+
+template class BoardFeatures<10, 19>;
+template class BoardFeatures<32, 64>;
+template class BoardFeatures<40, 100>;
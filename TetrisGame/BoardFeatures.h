@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include "BitBoard.h"
+
+// Weights of the linear board evaluation used by the bots. Positive weights reward a feature.
+struct EvaluationWeights {
+	double aggregateHeight{ -0.51 };	// Sum of the column heights
+	double holes{ -7.9 };				// Empty cells under the top of their column
+	double bumpiness{ -0.18 };			// Sum of the height differences of neighbouring columns
+	double wells{ -3.4 };				// Sum of 1 + 2 + ... + depth over every well (walls are high)
+	double rowTransitions{ -3.2 };		// Filled/empty changes along the rows, walls filled
+	double columnTransitions{ -9.3 };	// Filled/empty changes down the columns, floor filled
+	double linesCleared{ 3.4 };			// Rows removed by the placement
+};
+
+/*
+ * The BoardFeatures class template holds the features of a BitBoard that the bots evaluate:
+ * column tops, holes and row & column transitions. compute() derives them from the row masks
+ * with popcounts over whole rows; place() locks a shape into a board and updates them from the
+ * cells the shape covers only, falling back to compute() when rows are removed. Bumpiness, wells
+ * & the aggregate height are summed from the column tops on request.
+ * Members are explicitly instantiated in BoardFeatures.cpp for the sizes listed there.
+ */
+template<int Width, int Height>
+class BoardFeatures {
+	friend class TestSuite;
+
+public:
+	typedef BitBoard<Width, Height> Board;
+	typedef typename Board::RowMask RowMask;
+
+private:
+	std::int8_t tops[Width];	// Row of the highest block of each column, Height if empty
+	int holes;
+	int rowTransitions;
+	int columnTransitions;
+	int linesCleared{ 0 };		// Rows removed by the last place()
+
+public:
+	// Constructors
+	BoardFeatures() { compute(Board()); }
+	explicit BoardFeatures(const Board& board) { compute(board); }
+
+	// Recompute every feature of a board.
+	void compute(const Board& board);
+
+	// Lock a shape into a board, remove the rows it completes and update the features.
+	// @param board: The board these features were computed for.
+	// @param piece: The shape & orientation.
+	// @param x, y: Grid location of the shape's origin, where it fits.
+	// @return: The number of rows removed.
+	int place(Board& board, const PieceMask& piece, int x, int y);
+
+	// Score the board: the weighted sum of its features.
+	double evaluate(const EvaluationWeights& weights) const;
+
+	// Accessors ===================================================================================
+
+	int getColumnHeight(int x) const { return Height - tops[x]; }
+	int getHoles() const { return holes; }
+	int getRowTransitions() const { return rowTransitions; }
+	int getColumnTransitions() const { return columnTransitions; }
+	int getLinesCleared() const { return linesCleared; }
+	int getAggregateHeight() const;
+	int getBumpiness() const;
+	int getWells() const;
+
+private:
+	// Get whether a cell is filled, counting the walls & floor as filled and the rows above the board as empty.
+	static bool isFilled(const Board& board, int x, int y);
+};
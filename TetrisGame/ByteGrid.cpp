@@ -0,0 +1,73 @@
+#include "ByteGrid.h"
+#include <cstring>
+
+#if !defined(BYTEGRID_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define BYTEGRID_SSE2
+#include <emmintrin.h>
+#endif
+#if !defined(BYTEGRID_SCALAR) && defined(__AVX2__)
+#define BYTEGRID_AVX2
+#include <immintrin.h>
+#endif
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+template<int Width, int Height>
+void ByteGrid<Width, Height>::fill(int value) {
+#if defined(BYTEGRID_AVX2)
+	const __m256i values = _mm256_set1_epi8(static_cast<char>(value));
+	std::int8_t* bytes = &cells[0][0];
+	int i{ 0 };
+	for (; i + 32 <= Height * ROW_STRIDE; i += 32)
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(bytes + i), values);
+	if (i < Height * ROW_STRIDE)	// an odd number of 16 byte chunks
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(bytes + i), _mm256_castsi256_si128(values));
+#elif defined(BYTEGRID_SSE2)
+	const __m128i values = _mm_set1_epi8(static_cast<char>(value));
+	std::int8_t* bytes = &cells[0][0];
+	for (int i = 0; i < Height * ROW_STRIDE; i += 16)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(bytes + i), values);
+#else
+	std::memset(cells, static_cast<std::int8_t>(value), sizeof(cells));
+#endif
+}
+
+template<int Width, int Height>
+void ByteGrid<Width, Height>::fillRow(int rowIdx, int value) {
+#if defined(BYTEGRID_SSE2)
+	const __m128i values = _mm_set1_epi8(static_cast<char>(value));
+	for (int c = 0; c < CHUNKS_PER_ROW; c++)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&cells[rowIdx][16 * c]), values);
+#else
+	std::memset(cells[rowIdx], static_cast<std::int8_t>(value), ROW_STRIDE);
+#endif
+}
+
+template<int Width, int Height>
+void ByteGrid<Width, Height>::copyRow(int srcRowIdx, int dstRowIdx) {
+#if defined(BYTEGRID_SSE2)
+	for (int c = 0; c < CHUNKS_PER_ROW; c++) {
+		__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&cells[srcRowIdx][16 * c]));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&cells[dstRowIdx][16 * c]), chunk);
+	}
+#else
+	std::memcpy(cells[dstRowIdx], cells[srcRowIdx], ROW_STRIDE);
+#endif
+}
+
+template<int Width, int Height>
+const char* ByteGrid<Width, Height>::getKernelName() {
+#if defined(BYTEGRID_AVX2)
+	return "avx2";
+#elif defined(BYTEGRID_SSE2)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+// EXPLICIT INSTANTIATIONS -------------------------------
+
+template class ByteGrid<10, 19>;	// Gameboard
+template class ByteGrid<32, 64>;
+template class ByteGrid<40, 100>;
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+
+/*
+ * The ByteGrid class template stores one signed byte per cell (a color, or EMPTY_CELL), with every
+ * row padded to a multiple of 16 bytes so rows can be filled & copied with whole SSE2 (16 byte) or
+ * AVX2 (32 byte) vectors. The padding is never read as a cell. Completed rows aren't looked for
+ * here: the Gameboard's row masks already track them.
+ * The vector kernels are picked at compile time from the target's instruction set; a scalar
+ * fallback is used when neither is available or BYTEGRID_SCALAR is defined.
+ * Members are explicitly instantiated in ByteGrid.cpp for the sizes listed there.
+ */
+template<int Width, int Height>
+class ByteGrid {
+	friend class TestSuite;
+
+public:
+	static const int ROW_STRIDE = (Width + 15) / 16 * 16;	// Bytes per row, padding included
+	static const int EMPTY_CELL = -1;						// Contents of an empty cell
+
+private:
+	static const int CHUNKS_PER_ROW = ROW_STRIDE / 16;		// 16 byte vectors per row
+
+	alignas(16) std::int8_t cells[Height][ROW_STRIDE];
+
+public:
+	// Get the content of a cell.
+	// @param x, y: A valid cell.
+	int get(int x, int y) const { return cells[y][x]; }
+
+	// Set the content of a cell.
+	// @param x, y: A valid cell.
+	// @param value: A color or EMPTY_CELL, within a signed byte.
+	void set(int x, int y, int value) { cells[y][x] = static_cast<std::int8_t>(value); }
+
+	// Set every cell (and the padding) to a value.
+	void fill(int value);
+
+	// Set every cell of a row (and its padding) to a value.
+	void fillRow(int rowIdx, int value);
+
+	// Copy a row over another one.
+	void copyRow(int srcRowIdx, int dstRowIdx);
+
+	// @return: The kernels compiled in: "avx2", "sse2" or "scalar".
+	static const char* getKernelName();
+};
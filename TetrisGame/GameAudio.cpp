@@ -0,0 +1,41 @@
+#include "GameAudio.h"
+#include "TetrisEngine.h"
+
+// STATIC CONSTANTS ======================================
+
+const char* const GameAudio::MUSIC_PATH{ "sounds/tetrisMusic.ogg" };
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+bool GameAudio::load(const AssetArchive* archive) {
+	const AssetArchive::Entry* music = archive ? archive->find(MUSIC_PATH) : nullptr;
+	bool musicOpened = archive ? music && tetrisMusic.openFromMemory(music->data, music->size)
+		: tetrisMusic.openFromFile(MUSIC_PATH);
+	if (!musicOpened) {
+		assert(false && "Missing music: tetrisMusic.ogg");
+		return false;
+	}
+	tetrisMusic.setVolume(50);
+	tetrisMusic.setLoop(true);
+
+	return effects.load(archive);
+}
+
+void GameAudio::handleEngineEvents(unsigned int events) {
+	if (hasEvent(events, GameEvent::GameOver)) {
+		tetrisMusic.stop();
+		effects.play(SoundEffect::GameOver);
+	}
+	if (hasEvent(events, GameEvent::GameReset)) {
+		tetrisMusic.play();
+	}
+	if (hasEvent(events, GameEvent::ShapeRotated)) {
+		effects.play(SoundEffect::Rotate);
+	}
+	if (hasEvent(events, GameEvent::ShapeLocked)) {
+		effects.play(SoundEffect::Drop);
+	}
+	if (hasEvent(events, GameEvent::LevelUp)) {
+		effects.play(SoundEffect::LevelUp);
+	}
+}
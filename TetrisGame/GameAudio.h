@@ -0,0 +1,34 @@
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include "AssetArchive.h"
+#include "SoundEffects.h"
+
+/*
+ * The GameAudio class holds the music & sounds of the game and plays them in response to engine
+ * events. It is loaded on its own (possibly on a worker thread) and attached to a TetrisGame
+ * once ready, so audio decoding doesn't hold up the first frame.
+ */
+class GameAudio {
+public:
+	// Static Constants ============================================================================
+	static const char* const MUSIC_PATH;
+
+private:
+	sf::Music tetrisMusic;		     // The Music for the Tetris Game
+	SoundEffects effects;		     // Rotate, drop, level up & game over sounds
+
+public:
+	// Opens the music stream and decodes the sound effects.
+	// @param archive: The archive to load from, or nullptr for loose files. The music streams
+	// from it, so it must outlive the GameAudio.
+	// @return: True if every file was loaded.
+	bool load(const AssetArchive* archive);
+
+	// Starts the music (when attached to a game in progress).
+	void startMusic() { tetrisMusic.play(); }
+
+	// Plays music/sounds for the events raised by the engine.
+	// @param events: GameEvent flags returned by TetrisEngine::takeEvents().
+	void handleEngineEvents(unsigned int events);
+};
@@ -1,14 +1,21 @@
 #include "Gameboard.h"
+#include <algorithm>
 
 // -------------- PUBLIC METHODS -------------- //
 
-void Gameboard::empty() {
-	for (int y = 0; y < MAX_Y; y++) {
-		fillRow(y, EMPTY_BLOCK);
-	}
+template<int Width, int Height>
+void BasicGameboard<Width, Height>::empty() {
+	grid.fill(EMPTY_BLOCK);
+	for (int y = 0; y < MAX_Y; y++)
+		rowMasks[y] = 0;
+	completedRows.reset();
+	for (int x = 0; x < MAX_X; x++)
+		columnTops[x] = MAX_Y;
+	hash = 0;
 }
 
-void Gameboard::printToConsole() const {
+template<int Width, int Height>
+void BasicGameboard<Width, Height>::printToConsole() const {
 	for (int y = 0; y < MAX_Y; y++) {
 		for (int x = 0; x < MAX_X; x++) {
 			int content{ getContent(x, y) };
@@ -18,100 +25,289 @@ void Gameboard::printToConsole() const {
 	}
 }
 
-int Gameboard::getContent(const Point& p) const {
+template<int Width, int Height>
+int BasicGameboard<Width, Height>::getContent(const Point& p) const {
 	assert(isValidPoint(p));
-	return grid[p.getY()][p.getX()];
+	return grid.get(p.getX(), p.getY());
 }
 
-int Gameboard::getContent(int x, int y) const {
+template<int Width, int Height>
+int BasicGameboard<Width, Height>::getContent(int x, int y) const {
 	assert(isValidPoint(x, y));
-	return grid[y][x];
+	return grid.get(x, y);
 }
 
-void Gameboard::setContent(const Point& p, int content) {
-	if (isValidPoint(p)) 
-		grid[p.getY()][p.getX()] = content;
+template<int Width, int Height>
+void BasicGameboard<Width, Height>::setContent(const Point& p, int content) {
+	setContent(p.getX(), p.getY(), content);
 }
 
-void Gameboard::setContent(int x, int y, int content) {
-	if (isValidPoint(x, y)) 
-		grid[y][x] = content;
+template<int Width, int Height>
+void BasicGameboard<Width, Height>::setContent(int x, int y, int content) {
+	if (isValidPoint(x, y)) {
+		assert(content == static_cast<std::int8_t>(content));
+		grid.set(x, y, content);
+		RowMask oldMask = rowMasks[y];
+		if (content == EMPTY_BLOCK)
+			rowMasks[y] &= static_cast<RowMask>(~getColumnBit(x));
+		else
+			rowMasks[y] |= getColumnBit(x);
+		completedRows[y] = (rowMasks[y] == FULL_ROW_MASK);
+		if (oldMask != rowMasks[y])
+			hash ^= ZobristKeys<Width, Height>::get().getCellKey(x, y);
+		updateColumnTops(y, oldMask);
+	}
 }
 
-void Gameboard::setContent(const std::vector<Point>& locs, int content) {
+template<int Width, int Height>
+void BasicGameboard<Width, Height>::setContent(const std::vector<Point>& locs, int content) {
 	for (const Point& p : locs) 
 		setContent(p, content);
 }
 
-bool Gameboard::areAllLocsEmpty(const std::vector<Point>& locs) const {
+template<int Width, int Height>
+bool BasicGameboard<Width, Height>::areAllLocsEmpty(const std::vector<Point>& locs) const {
 	for (const Point& p : locs) {
-		if (isValidPoint(p) && getContent(p) != EMPTY_BLOCK) 
+		if (isValidPoint(p) && (rowMasks[p.getY()] & getColumnBit(p.getX())))
 			return false;
 	}
 	return true;
 }
 
-int Gameboard::removeCompletedRows() {
-	std::vector<int> completedRows{ getCompletedRowIndices() };
+template<int Width, int Height>
+typename BasicGameboard<Width, Height>::RowMask BasicGameboard<Width, Height>::getRowMask(int rowIdx) const {
+	assert(0 <= rowIdx && rowIdx < MAX_Y);
+	return rowMasks[rowIdx];
+}
+
+template<int Width, int Height>
+bool BasicGameboard<Width, Height>::isRowMaskClear(int rowIdx, RowMask mask) const {
+	if (rowIdx < 0)
+		return true;
+	if (rowIdx >= MAX_Y)
+		return mask == 0;
+	return (rowMasks[rowIdx] & mask) == 0;
+}
 
-	if (!completedRows.empty()) {
-		removeRows(completedRows);
-		/*std::this_thread::sleep_for(std::chrono::milliseconds(500));*/
+template<int Width, int Height>
+int BasicGameboard<Width, Height>::getRowFillCount(int rowIdx) const {
+	assert(0 <= rowIdx && rowIdx < MAX_Y);
+	return static_cast<int>(std::bitset<MAX_X>(rowMasks[rowIdx]).count());
+}
+
+template<int Width, int Height>
+int BasicGameboard<Width, Height>::getColumnHeight(int x) const {
+	assert(0 <= x && x < MAX_X);
+	return MAX_Y - columnTops[x];
+}
+
+template<int Width, int Height>
+int BasicGameboard<Width, Height>::getDropDistance(const Point* locs, int count) const {
+	int distance{ MAX_Y };
+	for (int i = 0; i < count; i++) {
+		assert(0 <= locs[i].getX() && locs[i].getX() < MAX_X && locs[i].getY() < MAX_Y);
+		int top{ columnTops[locs[i].getX()] };
+		if (locs[i].getY() >= top) {
+			distance = -1;	// Under an overhang, the skyline can't answer.
+			break;
+		}
+		distance = std::min(distance, top - 1 - locs[i].getY());
 	}
+	if (distance >= 0)
+		return distance;
 
-	return completedRows.size();
+	distance = 0;
+	for (;;) {
+		for (int i = 0; i < count; i++) {
+			if (!isRowMaskClear(locs[i].getY() + distance + 1, getColumnBit(locs[i].getX())))
+				return distance;
+		}
+		distance++;
+	}
+}
+
+template<int Width, int Height>
+int BasicGameboard<Width, Height>::getShiftDistance(const Point* locs, int count, int direction) const {
+	assert(direction == -1 || direction == 1);
+	int distance{ MAX_X };
+	for (int i = 0; i < count; i++) {
+		assert(0 <= locs[i].getX() && locs[i].getX() < MAX_X && locs[i].getY() < MAX_Y);
+		RowMask row{ locs[i].getY() >= 0 ? rowMasks[locs[i].getY()] : RowMask(0) };
+		int free{ 0 };
+		for (int x = locs[i].getX() + direction; 0 <= x && x < MAX_X && !(row & getColumnBit(x)); x += direction)
+			free++;
+		distance = std::min(distance, free);
+	}
+	return distance;
+}
+
+template<int Width, int Height>
+int BasicGameboard<Width, Height>::removeCompletedRows() {
+	return compactRows(completedRows);
 }
 
 // -------------- PRIVATE METHODS -------------- //
 
-bool Gameboard::isValidPoint(const Point& p) const {
+template<int Width, int Height>
+bool BasicGameboard<Width, Height>::isValidPoint(const Point& p) const {
 	return ((0 <= p.getX() && p.getX() < MAX_X) && (0 <= p.getY() && p.getY() < MAX_Y));
 }
 
-bool Gameboard::isValidPoint(int x, int y) const {
+template<int Width, int Height>
+bool BasicGameboard<Width, Height>::isValidPoint(int x, int y) const {
 	return ((0 <= x && x < MAX_X) && (0 <= y && y < MAX_Y));
 }
 
-bool Gameboard::isRowCompleted(int rowIdx) const {
-	assert(0 <= rowIdx < MAX_Y);
-	for (int x = 0; x < MAX_X; x++) {
-		if (getContent(x, rowIdx) == EMPTY_BLOCK) 
-			return false;
-	}
-	return true;
+template<int Width, int Height>
+bool BasicGameboard<Width, Height>::isRowCompleted(int rowIdx) const {
+	assert(0 <= rowIdx && rowIdx < MAX_Y);
+	return completedRows[rowIdx];
 }
 
-void Gameboard::fillRow(int rowIdx, int content) {
-	assert(0 <= rowIdx < MAX_Y);
-	for (int x = 0; x < MAX_X; x++)
-		setContent(x, rowIdx, content);
+template<int Width, int Height>
+void BasicGameboard<Width, Height>::fillRow(int rowIdx, int content) {
+	assert(0 <= rowIdx && rowIdx < MAX_Y);
+	assert(content == static_cast<std::int8_t>(content));
+	grid.fillRow(rowIdx, content);
+	RowMask oldMask = rowMasks[rowIdx];
+	rowMasks[rowIdx] = (content == EMPTY_BLOCK) ? 0 : FULL_ROW_MASK;
+	completedRows[rowIdx] = (content != EMPTY_BLOCK);
+	hash ^= ZobristKeys<Width, Height>::get().getRowKey(rowIdx, oldMask ^ rowMasks[rowIdx]);
+	updateColumnTops(rowIdx, oldMask);
 }
 
-std::vector<int> Gameboard::getCompletedRowIndices() const {
-	std::vector<int> completedRows;
+template<int Width, int Height>
+std::vector<int> BasicGameboard<Width, Height>::getCompletedRowIndices() const {
+	std::vector<int> completedRowIndices;
+	if (completedRows.none())
+		return completedRowIndices;
+
 	for (int y = 0; y < MAX_Y; y++) 
-		if (isRowCompleted(y)) {
-			completedRows.push_back(y);
+		if (completedRows[y]) {
+			completedRowIndices.push_back(y);
 	}
-	return completedRows;
+	return completedRowIndices;
 }
 
-void Gameboard::copyRowIntoRow(int srcRowIdx, int dstRowIdx) {
+template<int Width, int Height>
+void BasicGameboard<Width, Height>::copyRowIntoRow(int srcRowIdx, int dstRowIdx) {
+	RowMask oldMask = rowMasks[dstRowIdx];
+	moveRow(srcRowIdx, dstRowIdx);
+	hash ^= ZobristKeys<Width, Height>::get().getRowKey(dstRowIdx, oldMask ^ rowMasks[dstRowIdx]);
+	updateColumnTops(dstRowIdx, oldMask);
+}
+
+template<int Width, int Height>
+void BasicGameboard<Width, Height>::moveRow(int srcRowIdx, int dstRowIdx) {
 	assert(0 <= srcRowIdx && srcRowIdx < MAX_Y && 0 <= dstRowIdx && dstRowIdx < MAX_Y);
-	for (int x = 0; x < MAX_X; x++) 
-		setContent(x, dstRowIdx, getContent(x, srcRowIdx));
+	grid.copyRow(srcRowIdx, dstRowIdx);
+	rowMasks[dstRowIdx] = rowMasks[srcRowIdx];
+	completedRows[dstRowIdx] = completedRows[srcRowIdx];
 }
 
-void Gameboard::removeRow(int rowIdx) {
-	assert(0 <= rowIdx && rowIdx < MAX_Y);
-	for (int y = rowIdx - 1; y >= 0; y--) 
-		copyRowIntoRow(y, y + 1);
+template<int Width, int Height>
+void BasicGameboard<Width, Height>::updateColumnTops(int rowIdx, RowMask oldMask) {
+	RowMask newMask = rowMasks[rowIdx];
+	if (oldMask == newMask)
+		return;
+
+	for (int x = 0; x < MAX_X; x++) {
+		RowMask bit = getColumnBit(x);
+		if ((newMask & bit) && rowIdx < columnTops[x]) {
+			columnTops[x] = rowIdx;
+		}
+		else if (!(newMask & bit) && rowIdx == columnTops[x]) {
+			// The top block of this column was cleared, find the next one down.
+			int y = rowIdx + 1;
+			while (y < MAX_Y && !(rowMasks[y] & bit))
+				y++;
+			columnTops[x] = y;
+		}
+	}
+}
+
+template<int Width, int Height>
+void BasicGameboard<Width, Height>::recomputeColumnTops() {
+	RowMask seen{ 0 };
+	for (int x = 0; x < MAX_X; x++)
+		columnTops[x] = MAX_Y;
+
+	for (int y = 0; y < MAX_Y && seen != FULL_ROW_MASK; y++) {
+		RowMask newlySeen = rowMasks[y] & ~seen;
+		for (int x = 0; newlySeen != 0; x++, newlySeen >>= 1) {
+			if (newlySeen & 1)
+				columnTops[x] = y;
+		}
+		seen |= rowMasks[y];
+	}
+}
 
-	fillRow(0, EMPTY_BLOCK);
+template<int Width, int Height>
+void BasicGameboard<Width, Height>::recomputeHash() {
+	const ZobristKeys<Width, Height>& keys = ZobristKeys<Width, Height>::get();
+	hash = 0;
+	for (int y = 0; y < MAX_Y; y++)
+		hash ^= keys.getRowKey(y, rowMasks[y]);
 }
 
-void Gameboard::removeRows(const std::vector<int>& rows) {
+template<int Width, int Height>
+void BasicGameboard<Width, Height>::removeRow(int rowIdx) {
+	assert(0 <= rowIdx && rowIdx < MAX_Y);
+	std::bitset<MAX_Y> rowsToRemove;
+	rowsToRemove[rowIdx] = true;
+	compactRows(rowsToRemove);
+}
+
+template<int Width, int Height>
+void BasicGameboard<Width, Height>::removeRows(const std::vector<int>& rows) {
+	std::bitset<MAX_Y> rowsToRemove;
 	for (int idx : rows) {
-		removeRow(idx);
+		assert(0 <= idx && idx < MAX_Y);
+		rowsToRemove[idx] = true;
+	}
+	compactRows(rowsToRemove);
+}
+
+template<int Width, int Height>
+int BasicGameboard<Width, Height>::compactRows(std::bitset<MAX_Y> rowsToRemove) {
+	if (rowsToRemove.none())
+		return 0;
+
+	// Rows below the lowest removed row keep their place: start the sweep there.
+	int lowestRowIdx = MAX_Y - 1;
+	while (!rowsToRemove[lowestRowIdx])
+		lowestRowIdx--;
+
+	// Only the swept rows change, so only their keys leave & re-enter the hash.
+	const ZobristKeys<Width, Height>& keys = ZobristKeys<Width, Height>::get();
+	for (int y = lowestRowIdx; y >= 0; y--)
+		hash ^= keys.getRowKey(y, rowMasks[y]);
+
+	// Sweep bottom-up, moving each kept row straight to its final position.
+	int dstRowIdx = lowestRowIdx;
+	for (int srcRowIdx = lowestRowIdx; srcRowIdx >= 0; srcRowIdx--) {
+		if (rowsToRemove[srcRowIdx])
+			continue;
+		if (srcRowIdx != dstRowIdx)
+			moveRow(srcRowIdx, dstRowIdx);
+		dstRowIdx--;
+	}
+
+	// Every removed row leaves an empty row at the top.
+	for (int y = dstRowIdx; y >= 0; y--) {
+		grid.fillRow(y, EMPTY_BLOCK);
+		rowMasks[y] = 0;
+		completedRows[y] = false;
 	}
+
+	for (int y = lowestRowIdx; y >= 0; y--)
+		hash ^= keys.getRowKey(y, rowMasks[y]);
+	recomputeColumnTops();
+	return static_cast<int>(rowsToRemove.count());
 }
+
+// EXPLICIT INSTANTIATIONS -------------------------------
+
+template class BasicGameboard<10, 19>;		// Gameboard, 16 bit rows
+template class BasicGameboard<32, 64>;		// 32 bit rows
+template class BasicGameboard<40, 100>;		// 64 bit rows
@@ -1,29 +1,58 @@
 #pragma once
 #include <vector>
+#include <bitset>
+#include <cstdint>
 #include <cassert>
+#include <type_traits>
 #include <iomanip> 
 #include <thread>
 #include <chrono>
 #include "Point.h"
+#include "ByteGrid.h"
+#include "Zobrist.h"
+
+template<int Width, int Height> class BasicTetrisEngine;
 
 /*
- * The Gameboard class represents the game grid used in Tetris.
+ * The BasicGameboard class template represents the game grid used in Tetris, with its dimensions
+ * fixed at compile time. Occupancy is kept as one bitmask per row (bit x set when column x is
+ * filled) next to a separate color plane, so collision and row checks are mask ANDs and compares.
+ * The color plane is a ByteGrid, whose padded rows are filled & copied with vector stores.
+ * A Zobrist hash of the occupancy is kept up to date as cells are filled, cleared & removed.
+ * The row mask is the narrowest unsigned type that fits a row: 16 bits up to 16 columns, then
+ * 32 or 64 bits. The member functions are explicitly instantiated in Gameboard.cpp for the sizes
+ * listed there; the game itself uses the Gameboard typedef below.
  */
-class Gameboard {
-	friend int main();  
-	friend class TetrisGame;
+template<int Width, int Height>
+class BasicGameboard {
+	template<int, int> friend class BasicTetrisEngine;
+	friend class TestSuite;
+	friend class Benchmark;
 public:
-	static const int MAX_X = 10;		// Gameboard x dimension
-	static const int MAX_Y = 19;		// Gameboard y dimension
+	static_assert(0 < Width && Width <= 64, "A row must fit in a 64 bit mask");
+	static_assert(0 < Height, "The board needs at least one row");
+
+	static const int MAX_X = Width;		// Gameboard x dimension
+	static const int MAX_Y = Height;	// Gameboard y dimension
 	static const int EMPTY_BLOCK = -1;	// Contents of an empty block
+	static_assert(EMPTY_BLOCK == ByteGrid<Width, Height>::EMPTY_CELL, "The color plane's empty cells are empty blocks");
+
+	// Occupancy bits of a single row (bit x = column x)
+	typedef typename std::conditional<(Width <= 16), std::uint16_t,
+		typename std::conditional<(Width <= 32), std::uint32_t, std::uint64_t>::type>::type RowMask;
+	// Mask of a completed row
+	static const RowMask FULL_ROW_MASK = static_cast<RowMask>(static_cast<RowMask>(~RowMask(0)) >> (8 * sizeof(RowMask) - Width));
 
 private:
-	int grid[MAX_Y][MAX_X];					// Grid to store block contents
-	const Point spawnLoc{ MAX_X / 2, 0 };   // Offset to span new tetromino at.
+	ByteGrid<Width, Height> grid;			// Color plane to store block contents (a TetColor or EMPTY_BLOCK)
+	RowMask rowMasks[MAX_Y];				// Occupancy plane, kept in sync with grid
+	std::bitset<MAX_Y> completedRows;		// Bit y is set while row y is completed; drives row removal
+	int columnTops[MAX_X];					// Skyline: row of the highest block per column (MAX_Y if empty)
+	std::uint64_t hash;						// Zobrist hash of the occupancy plane
 
 public:
 	// Constructor for Gameboard. Initalizes the grid by emptying it.
-	Gameboard() { empty(); };
+	BasicGameboard() { empty(); };
 
 	// Fill the gameboard with EMPTY_BLOCK .
 	void empty();
@@ -63,13 +92,65 @@ public:
 	// @return: True if all locations are empty, false otherwise. 
 	bool areAllLocsEmpty(const std::vector<Point>& locs) const;
 
-	// Remove all completed rows from the board and return the number of removed rows.
+	// Get the mask bit of a column.
+	// @param x: The column index.
+	// @return: The row mask with only bit x set.
+	static RowMask getColumnBit(int x) { return static_cast<RowMask>(RowMask(1) << x); }
+
+	// Get the occupancy mask of a row.
+	// @param rowIdx: The index of the row.
+	// @return: The row mask, bit x is set when the block at (x, rowIdx) is not empty.
+	RowMask getRowMask(int rowIdx) const;
+
+	// Determine if none of the masked blocks of a row are occupied. Rows above the board
+	// are considered clear, rows below it are considered full.
+	// @param rowIdx: The index of the row (may be outside the board).
+	// @param mask: The blocks of the row to test.
+	// @return: True if none of the masked blocks are occupied, false otherwise.
+	bool isRowMaskClear(int rowIdx, RowMask mask) const;
+
+	// Get the set of completed rows. Maintained as blocks are set, so reading it is O(1).
+	// @return: Bit y is set if row y is completed.
+	std::bitset<MAX_Y> getCompletedRows() const { return completedRows; }
+
+	// Get the number of filled blocks in a row.
+	// @param rowIdx: The index of the row.
+	// @return: The number of non-empty blocks in the row.
+	int getRowFillCount(int rowIdx) const;
+
+	// Get the height of a column's surface (0 for an empty column, MAX_Y for a full one).
+	// @param x: The column index.
+	// @return: The number of rows from the floor up to and including the column's highest block.
+	int getColumnHeight(int x) const;
+
+	// Get how many rows a set of blocks can fall before hitting the floor or another block.
+	// Blocks above the skyline take the minimum over their columns; blocks tucked under an
+	// overhang fall back to stepping down through the row masks.
+	// @param locs: Points of the falling blocks, all within the left, right & bottom borders.
+	// @param count: The number of points.
+	// @return: The number of rows the blocks can move down.
+	int getDropDistance(const Point* locs, int count) const;
+
+	// Get how many columns a set of blocks can slide sideways before hitting a wall or another
+	// block, scanning each block's row mask. The horizontal counterpart of getDropDistance().
+	// @param locs: Points of the sliding blocks, all within the left, right & bottom borders.
+	// @param count: The number of points.
+	// @param direction: -1 to slide left, 1 to slide right.
+	// @return: The number of columns the blocks can move.
+	int getShiftDistance(const Point* locs, int count, int direction) const;
+
+	// Get the Zobrist hash of the occupancy (colors aren't hashed). Boards with the same filled
+	// cells have the same hash, equal to BitBoard::getHash() for the same cells.
+	std::uint64_t getHash() const { return hash; }
+
+	// Remove all completed rows from the board in a single compaction pass. The rows come from the
+	// completed-row set kept up to date by every write, so the board is never rescanned for them.
 	// @return: The number of removed rows. 
 	int removeCompletedRows();
 
 	// Get the spawn location
 	// @return: The spawn location as a Point. 
-	Point getSpawnLoc() { return spawnLoc; };
+	Point getSpawnLoc() const { return Point(MAX_X / 2, 0); };
 
 private:
 
@@ -103,14 +184,39 @@ private:
 	// @param dstRowIdx: The index of the target row. 
 	void copyRowIntoRow(int srcRowIdx, int dstRowIdx);
 
-	// Removes the specified row and triggers a cascade effect by copying each row above it
-	// into itself, shifting the grid above the specified row downward. The top row is then
+	// Copy the color plane, mask & completed bit of a row without maintaining the skyline.
+	// Callers are responsible for updating columnTops afterwards.
+	// @param srcRowIdx: The index of the source row. 
+	// @param dstRowIdx: The index of the target row. 
+	void moveRow(int srcRowIdx, int dstRowIdx);
+
+	// Update the skyline after the mask of a row changed.
+	// @param rowIdx: The index of the row that changed.
+	// @param oldMask: The mask of the row before it changed.
+	void updateColumnTops(int rowIdx, RowMask oldMask);
+
+	// Rebuild the whole skyline from the row masks, top-down.
+	void recomputeColumnTops();
+
+	// Rebuild the hash from the row masks.
+	void recomputeHash();
+
+	// Removes the specified row, shifting the grid above the specified row downward. The top row is then
 	// filled with empty blocks to compensate for the shift.
-	// @param rowIdx: The row to remove and initiate the grid cascade effect.
+	// @param rowIdx: The row to remove.
 	void removeRow(int rowIdx);
 
 	// Removes the specified rows from the board and compensates for the removed rows.
 	// @param rows: A vector of row indexes that are complete and should be removed.
 	void removeRows(const std::vector<int>& rows);
+
+	// Removes a set of rows in one bottom-up sweep from the lowest removed row: every kept row above
+	// it is copied at most once, straight to its final position, and the rows freed at the top are
+	// emptied. Rows below the lowest removed row are never touched.
+	// @param rowsToRemove: Bit y is set if row y should be removed.
+	// @return: The number of removed rows.
+	int compactRows(std::bitset<MAX_Y> rowsToRemove);
 };
 
+// The standard board the game is played on.
+typedef BasicGameboard<10, 19> Gameboard;
@@ -10,12 +10,12 @@ void GridTetromino::move(int xOffset, int yOffset) {
 	gridLoc.setY(gridLoc.getY() + yOffset);
 }
 
-std::vector<Point> GridTetromino::getBlockLocsMappedToGrid() const {
-	std::vector<Point> gridLocPoints;
-	for (const Point& p: blockLocs) {
-		gridLocPoints.push_back(Point(
+GridTetromino::BlockLocs GridTetromino::getBlockLocsMappedToGrid() const {
+	BlockLocs gridLocPoints{ getBlockLocs() };
+	for (Point& p : gridLocPoints) {
+		p.setXY(
 			p.getX() + gridLoc.getX(), 
-			p.getY() + gridLoc.getY()));
+			p.getY() + gridLoc.getY());
 	}
 	return gridLocPoints;
-}
+}
\ No newline at end of file
@@ -1,6 +1,6 @@
 #pragma once
 #include "Tetromino.h"
-#include <vector>
+#include <type_traits>
 
 /*
  * The GridTetromino class extends the base Tetromino class, representing a Tetromino
@@ -17,11 +17,6 @@ public:
 		: Tetromino(), gridLoc(0,0) 
 	{}
 
-	// Copy Constructor.
-	GridTetromino(const GridTetromino& other)
-		: Tetromino(other), gridLoc(other.gridLoc)
-	{}
-
 	// Two GridTetrominos are identical if they have the same gridLoc and Shape.
 	friend bool operator==(const GridTetromino& x, const GridTetromino& y);
 
@@ -40,6 +35,8 @@ public:
 	void move(int xOffset, int yOffset);
 
 	// Get the block locations of the Tetromino mapped to the grid. 
-	// @return: A vector of Point objects representing the block locations.
-	std::vector<Point> getBlockLocsMappedToGrid() const;
+	// @return: A fixed array of Point objects representing the block locations.
+	BlockLocs getBlockLocsMappedToGrid() const;
 };
+
+static_assert(std::is_trivially_copyable<GridTetromino>::value, "GridTetromino is copied on every move attempt");
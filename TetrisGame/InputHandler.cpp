@@ -0,0 +1,121 @@
+#include "InputHandler.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+	const double NEVER = std::numeric_limits<double>::infinity();
+	const double MIN_REPEAT_SECONDS = 0.001;	// Floor for soft drop repeats, which have no instant mode.
+
+	// The held key index of a repeating input.
+	int heldKeyIndex(GameInput input) {
+		switch (input) {
+			case GameInput::MoveLeft:  return 0;
+			case GameInput::MoveRight: return 1;
+			case GameInput::SoftDrop:  return 2;
+			default:                   return -1;
+		}
+	}
+
+	const GameInput HELD_KEY_INPUTS[] = { GameInput::MoveLeft, GameInput::MoveRight, GameInput::SoftDrop };
+}
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+void InputHandler::press(GameInput input, double time) {
+	KeyEvent event{ time, input, true };
+	pending.insert(std::upper_bound(pending.begin(), pending.end(), event,
+		[](const KeyEvent& a, const KeyEvent& b) { return a.time < b.time; }), event);
+}
+
+void InputHandler::release(GameInput input, double time) {
+	if (heldKeyIndex(input) < 0) {
+		return;
+	}
+	KeyEvent event{ time, input, false };
+	pending.insert(std::upper_bound(pending.begin(), pending.end(), event,
+		[](const KeyEvent& a, const KeyEvent& b) { return a.time < b.time; }), event);
+}
+
+void InputHandler::update(TetrisEngine& engine, double until) {
+	for (;;) {
+		double eventTime{ pending.empty() ? NEVER : pending.front().time };
+		int repeatIdx{ -1 };
+		double repeatTime{ NEVER };
+		for (int i = 0; i < HELD_KEY_COUNT; i++) {
+			if (heldKeys[i].repeating && heldKeys[i].nextRepeat < repeatTime) {
+				repeatIdx = i;
+				repeatTime = heldKeys[i].nextRepeat;
+			}
+		}
+		if (eventTime >= until && repeatTime >= until) {
+			break;
+		}
+
+		if (eventTime <= repeatTime) {
+			KeyEvent event = pending.front();
+			pending.pop_front();
+			apply(engine, event);
+		}
+		else {
+			repeat(engine, HELD_KEY_INPUTS[repeatIdx], until);
+		}
+	}
+}
+
+// PRIVATE METHODS ---------------------------------------
+
+InputHandler::HeldKey* InputHandler::getHeldKey(GameInput input) {
+	int idx{ heldKeyIndex(input) };
+	return idx < 0 ? nullptr : &heldKeys[idx];
+}
+
+void InputHandler::apply(TetrisEngine& engine, const KeyEvent& event) {
+	HeldKey* key = getHeldKey(event.input);
+	HeldKey* opposite = nullptr;
+	if (event.input == GameInput::MoveLeft) {
+		opposite = getHeldKey(GameInput::MoveRight);
+	}
+	else if (event.input == GameInput::MoveRight) {
+		opposite = getHeldKey(GameInput::MoveLeft);
+	}
+
+	if (!event.pressed) {
+		key->held = false;
+		key->repeating = false;
+		if (opposite && opposite->held) {	// the other direction takes over again
+			opposite->repeating = true;
+			opposite->nextRepeat = event.time + config.dasSeconds;
+		}
+		return;
+	}
+
+	if (key && key->held) {
+		return;		// key repeat from the OS, we do our own
+	}
+	engine.handleInput(event.input);
+	if (key) {
+		key->held = true;
+		key->repeating = true;
+		key->nextRepeat = event.time + (event.input == GameInput::SoftDrop ?
+			std::max(config.softDropSeconds, MIN_REPEAT_SECONDS) : config.dasSeconds);
+	}
+	if (opposite) {
+		opposite->repeating = false;	// the last pressed direction wins
+	}
+}
+
+void InputHandler::repeat(TetrisEngine& engine, GameInput input, double until) {
+	HeldKey* key = getHeldKey(input);
+	if (input == GameInput::SoftDrop) {
+		engine.handleInput(input);
+		key->nextRepeat += std::max(config.softDropSeconds, MIN_REPEAT_SECONDS);
+	}
+	else if (config.arrSeconds <= 0.0) {
+		engine.shiftToWall(input);
+		key->nextRepeat = until;	// keep the shape against the wall from the next step on
+	}
+	else {
+		engine.handleInput(input);
+		key->nextRepeat += config.arrSeconds;
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <deque>
+#include "TetrisEngine.h"
+
+/*
+ * The InputHandler class turns timestamped key presses & releases into engine inputs, with
+ * delayed auto shift (DAS) and auto repeat (ARR) that don't depend on the OS key repeat or the
+ * frame rate. Events are queued with the time they happened and applied, together with any
+ * repeats that fell due, in time order by update() from the fixed logic step, so several
+ * repeats can land within one step. An ARR of 0 slides the shape to the wall in one move.
+ * Times are in seconds, in the same time base as the update() calls.
+ */
+class InputHandler {
+	friend class TestSuite;
+
+public:
+	struct Config {
+		double dasSeconds{ 0.167 };			// Hold time before a sideways move starts repeating.
+		double arrSeconds{ 0.033 };			// Time between sideways repeats, 0 to slide to the wall.
+		double softDropSeconds{ 0.033 };	// Time between soft drop repeats, held from the first press.
+	};
+
+private:
+	// A key press or release waiting to be applied.
+	struct KeyEvent {
+		double time;
+		GameInput input;
+		bool pressed;
+	};
+
+	// State of a key that repeats while held (MoveLeft, MoveRight, SoftDrop).
+	struct HeldKey {
+		bool held{ false };
+		bool repeating{ false };	// False while held but overridden by the opposite direction.
+		double nextRepeat{ 0.0 };	// Time of the next repeat while repeating.
+	};
+
+	static const int HELD_KEY_COUNT = 3;	// MoveLeft, MoveRight, SoftDrop
+
+	Config config;
+	std::deque<KeyEvent> pending;		// In time order.
+	HeldKey heldKeys[HELD_KEY_COUNT];
+
+public:
+	// Constructors
+	// @param config: The DAS & ARR timings, defaults if not given.
+	InputHandler() {}
+	explicit InputHandler(const Config& config) : config(config) {}
+
+	// Queue a key press.
+	// @param input: The input the key maps to.
+	// @param time: When the key went down, not before the previous event.
+	void press(GameInput input, double time);
+
+	// Queue a key release. Ignored for inputs that don't repeat.
+	// @param input: The input the key maps to.
+	// @param time: When the key went up, not before the previous event.
+	void release(GameInput input, double time);
+
+	// Apply every queued event and every repeat due before a given time to the engine, in time order.
+	// @param engine: The engine receiving the inputs.
+	// @param until: End of the logic step being processed.
+	void update(TetrisEngine& engine, double until);
+
+	void setConfig(const Config& config) { this->config = config; }
+	const Config& getConfig() const { return config; }
+
+private:
+	// Get the held key state of a repeating input.
+	// @return: The state, or nullptr if the input doesn't repeat.
+	HeldKey* getHeldKey(GameInput input);
+
+	// Apply a key press or release to the engine & the held key states.
+	void apply(TetrisEngine& engine, const KeyEvent& event);
+
+	// Apply one auto repeat of a held key.
+	void repeat(TetrisEngine& engine, GameInput input, double until);
+};
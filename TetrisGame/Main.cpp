@@ -1,60 +1,320 @@
 #include <SFML/Graphics.hpp>
 #include <iostream>
+#include <ctime>
+#include <chrono>
+#include <string>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
 #include "TetrisGame.h"
+#include "TetrisRenderer.h"
+#include "AssetLoader.h"
+#include "AssetArchive.h"
+#include "StartupProfile.h"
+#include "Replay.h"
+#include "SelfPlay.h"
+#include "BeamSearch.h"
+#include "Benchmark.h"
+#include "Perft.h"
 #include "TestSuite.h"
 
 
-int main() {	
-	std::srand(static_cast<unsigned int>(std::time(nullptr)));  // Seed the Randomizer
-	TestSuite::runTestSuite();									// Run some Test Suites
+// Play a recorded game headless, as fast as possible, and print how it ended.
+// @param path: The replay file to play.
+// @return: The process exit code.
+int playReplay(const std::string& path) {
+	Replay replay;
+	if (!replay.loadFromFile(path)) {
+		std::cerr << "Could not read replay: " << path << "\n";
+		return 1;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	ReplayPlayer player(replay);
+	player.playToEnd();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	if (player.isMalformed()) {
+		std::cerr << "Malformed replay event after " << player.getEventIndex() << " events: " << path << "\n";
+		return 1;
+	}
+
+	const TetrisEngine& engine = player.getEngine();
+	std::cout << "seed: " << replay.getSeed() << "\n"
+			  << "events: " << player.getEventIndex() << " (" << replay.getByteCount() << " bytes)\n"
+			  << "placements: " << player.getPlacementCount() << "\n"
+			  << "game time: " << player.getTimeMs() / 1000.0 << " s, played in " << elapsed.count() << " s\n"
+			  << "final score: " << engine.getScore() << ", lines: " << engine.getLinesCleared() << "\n";
+	return 0;
+}
+
+
+// Parse a whole command line argument as a number.
+// @param arg: The argument.
+// @param value: Set to the number.
+// @param parse: std::stoi, std::stoull or std::stod.
+// @return: False if the argument isn't a number, has trailing characters or is out of range.
+template<typename T, typename Parse>
+bool parseNumber(const std::string& arg, T& value, Parse parse) {
+	try {
+		std::size_t used{ 0 };
+		value = parse(arg, &used);
+		return used == arg.size();
+	}
+	catch (const std::logic_error&) {		// std::invalid_argument or std::out_of_range
+		return false;
+	}
+}
+
+bool parseNumber(const std::string& arg, int& value) {
+	return parseNumber(arg, value, [](const std::string& s, std::size_t* used) { return std::stoi(s, used); });
+}
+
+bool parseNumber(const std::string& arg, std::uint64_t& value) {
+	return arg.find('-') == std::string::npos &&		// std::stoull wraps negative numbers around
+		parseNumber(arg, value, [](const std::string& s, std::size_t* used) { return std::stoull(s, used); });
+}
+
+bool parseNumber(const std::string& arg, double& value) {
+	return parseNumber(arg, value, [](const std::string& s, std::size_t* used) { return std::stod(s, used); });
+}
+
+
+// Play a batch of headless games and print throughput & distributions.
+// @param argc/argv: The command line, after "--selfplay": [games] [threads] [seed] [random|heuristic|beam]
+// @return: The process exit code.
+int runSelfPlay(int argc, char* argv[]) {
+	SelfPlayRunner::Config config;
+	std::string policy{ argc > 3 ? argv[3] : "random" };
+	if ((argc > 0 && (!parseNumber(argv[0], config.games) || config.games <= 0)) ||
+		(argc > 1 && (!parseNumber(argv[1], config.threads) || config.threads < 0)) ||
+		(argc > 2 && !parseNumber(argv[2], config.baseSeed)) ||
+		(policy != "random" && policy != "heuristic" && policy != "beam")) {
+		std::cerr << "usage: Tetris --selfplay [games > 0] [threads, 0 for one per core] [seed] [random|heuristic|beam]\n";
+		return 2;
+	}
+
+	SelfPlayRunner runner(config, [policy](std::uint64_t seed) {
+		if (policy == "heuristic")
+			return std::unique_ptr<PlacementPolicy>(new HeuristicPolicy());
+		if (policy == "beam")
+			return std::unique_ptr<PlacementPolicy>(new BeamSearchPolicy());	// one thread, the games are parallel
+		return std::unique_ptr<PlacementPolicy>(new RandomPolicy(seed));
+	});
+	SelfPlayRunner::Stats stats = runner.run();
+
+	auto printDistribution = [](const char* name, const SelfPlayRunner::Distribution& d) {
+		std::cout << name << ": min " << d.min << ", mean " << d.mean << ", p50 " << d.p50
+				  << ", p90 " << d.p90 << ", p99 " << d.p99 << ", max " << d.max << "\n";
+	};
+	std::cout << "games: " << stats.games << " on " << stats.threads << " threads in " << stats.wallSeconds << " s\n"
+			  << "pieces: " << stats.totalPieces << " (" << stats.piecesPerSecond << " /s)\n"
+			  << "lines: " << stats.totalLines << " (" << stats.linesPerSecond << " /s)\n";
+	printDistribution("score", stats.score);
+	printDistribution("game length (pieces)", stats.gameLength);
+	return 0;
+}
+
+
+// Count the placement sequences of the next shapes from an empty board and print the counts &
+// throughput of every depth up to the one asked for.
+// @param argc/argv: The command line, after "--perft": [depth] [threads] [seed] [tucks (0/1)]
+// @return: The process exit code.
+int runPerft(int argc, char* argv[]) {
+	int depth{ 4 }, threads{ 0 }, tucks{ 0 };
+	std::uint64_t seed{ 1 };
+	if ((argc > 0 && (!parseNumber(argv[0], depth) || depth < 1)) ||
+		(argc > 1 && (!parseNumber(argv[1], threads) || threads < 0)) ||
+		(argc > 2 && !parseNumber(argv[2], seed)) ||
+		(argc > 3 && (!parseNumber(argv[3], tucks) || (tucks != 0 && tucks != 1)))) {
+		std::cerr << "usage: Tetris --perft [depth >= 1] [threads, 0 for one per core] [seed] [tucks (0/1)]\n";
+		return 2;
+	}
+	bool includeTucks{ tucks != 0 };
+
+	Gameboard board;
+	Perft perft(board, seed, depth, includeTucks);
+	for (int d = 1; d <= depth; d++) {
+		Perft::Result result = perft.run(d, threads);
+		std::cout << "depth " << d << ": " << result.nodes << " nodes in "
+				  << result.seconds << " s on " << result.threads << " threads (" << result.nodesPerSecond << " nodes/s)\n";
+	}
+	return 0;
+}
+
+
+// Options of an interactive game.
+struct GameOptions {
+	bool smoothFall{ false };
+	bool demo{ false };
+	int lookahead{ 1 };				// # of shapes the demo player looks at
+	InputHandler::Config input;
+};
+
+
+// Read the options of an interactive game, ignoring arguments that aren't options.
+// @param argc/argv: The whole command line: [--smooth-fall] [--das <ms>] [--arr <ms>] [--lookahead <shapes>] [--demo]
+// @param options: Set from the options found.
+// @return: False if an option's value is missing or invalid.
+bool parseGameOptions(int argc, char* argv[], GameOptions& options) {
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		double ms{ 0 };
+		if (arg == "--smooth-fall") {
+			options.smoothFall = true;
+		}
+		else if (arg == "--demo") {
+			options.demo = true;		// attract mode, until a game key is pressed
+		}
+		else if (arg == "--lookahead") {
+			if (++i >= argc || !parseNumber(argv[i], options.lookahead) || options.lookahead < 1)
+				return false;
+		}
+		else if (arg == "--das") {
+			if (++i >= argc || !parseNumber(argv[i], ms) || ms < 0)
+				return false;
+			options.input.dasSeconds = ms / 1000.0;
+		}
+		else if (arg == "--arr") {
+			if (++i >= argc || !parseNumber(argv[i], ms) || ms < 0)
+				return false;
+			options.input.arrSeconds = ms / 1000.0;	// 0 slides to the wall
+		}
+	}
+	return true;
+}
+
+
+// Get the directory of the executable, so assets are found whatever the working directory.
+// @param argv0: The program path as launched.
+// @return: The directory with a trailing separator, or empty if argv0 has none.
+std::string getExecutableDirectory(const std::string& argv0) {
+	std::string::size_type slash = argv0.find_last_of("/\\");
+	return slash == std::string::npos ? std::string() : argv0.substr(0, slash + 1);
+}
+
+
+int main(int argc, char* argv[]) {	
+	if (argc >= 3 && std::string(argv[1]) == "--replay") {		// Tetris --replay <file>
+		return playReplay(argv[2]);
+	}
+	if (argc >= 2 && std::string(argv[1]) == "--selfplay") {	// Tetris --selfplay [games] [threads] [seed] [policy]
+		return runSelfPlay(argc - 2, argv + 2);
+	}
+	if (argc >= 2 && std::string(argv[1]) == "--perft") {		// Tetris --perft [depth] [threads] [seed] [tucks]
+		return runPerft(argc - 2, argv + 2);
+	}
+	if (argc >= 2 && std::string(argv[1]) == "--bench") {		// Tetris --bench [min seconds per op] > results.csv
+		double minSeconds{ 0.25 };
+		if (argc >= 3 && (!parseNumber(argv[2], minSeconds) || minSeconds < 0)) {
+			std::cerr << "usage: Tetris --bench [min seconds per op >= 0]\n";
+			return 2;
+		}
+		Benchmark::printCsv(std::cout, Benchmark(minSeconds).runAll());
+		return 0;
+	}
+	GameOptions options;
+	if (!parseGameOptions(argc, argv, options)) {
+		std::cerr << "usage: Tetris [--smooth-fall] [--das <ms>] [--arr <ms>] [--lookahead <shapes >= 1>] [--demo]\n";
+		return 2;
+	}
+
+	StartupProfile profile;			// Time of each startup stage, printed at the first frame
+	AssetArchive archive;			// assets.pak next to the executable, else loose files in the working directory
+	{
+		StartupProfile::Scope scope(profile, "map assets.pak");
+		if (!archive.open(getExecutableDirectory(argv[0]) + "assets.pak")) {
+			archive.open("assets.pak");
+		}
+	}
+	AssetLoader assets(profile, archive.isOpen() ? &archive : nullptr);	// Images, font & audio load on worker threads from here on
+	{
+		StartupProfile::Scope scope(profile, "test suite");
+		TestSuite::runTestSuite();								// Run some Test Suites
+	}
+	const std::uint64_t seed = static_cast<std::uint64_t>(std::time(nullptr));	// Seed of the game
+	std::cout << "seed: " << seed << "\n";
 
 	/*--------- Load & Set Sprites/ Textures used in Game ---------*/
 
-	sf::Sprite blockSprite;									  // The tetromino block sprite
 	sf::Texture blockTexture;								  // The tetromino block texture
-	sf::Sprite backgroundSprite;							  // The background sprite
 	sf::Texture backgroundTexture;							  // The background texture
-	backgroundTexture.loadFromFile("images/background.png");  // Load the Background Sprite
-	backgroundSprite.setTexture(backgroundTexture);			  // Set texture of Background Sprite
-	blockTexture.loadFromFile("images/tiles.png");			  // Load the Tetris Block Sprite
-	blockSprite.setTexture(blockTexture);					  // Set texture of Tetris Block Sprite
+	assets.loadTextures(backgroundTexture, blockTexture);	  // Wait for the decoded images, upload them
 
 	/*------------------ Create the Game Window ------------------*/
 
+	const double windowStart = profile.getElapsedMs();
 	sf::RenderWindow window(sf::VideoMode(640, 800), "Tetris Game Window");	
-	window.setFramerateLimit(30);				// set a max framerate of 30 FPS
+	profile.record("create window", windowStart, profile.getElapsedMs());
+	window.setFramerateLimit(60);				// set a max framerate of 60 FPS (render thread only)
 	const Point gameboardOffset{ 54, 125 };		// the pixel offset of the top left of the gameboard 
 	const Point nextShapeOffset{ 490, 210 };	// the pixel offset of the next shape Tetromino
 
 	/*--------------------- Set up the Game ----------------------*/
 
-	TetrisGame game(window, blockSprite, gameboardOffset, nextShapeOffset);
+	TetrisGame game(seed);
+	TetrisRenderer renderer(window.getSize(), backgroundTexture, blockTexture, gameboardOffset, nextShapeOffset,
+		assets.getFont());
+	renderer.setSmoothFall(options.smoothFall);
+	game.setDemoLookahead(options.lookahead);
+	game.setDemoMode(options.demo);
+	game.setInputConfig(options.input);
+	window.setKeyRepeatEnabled(false);			// DAS & ARR are handled by the game, not the OS
+	const sf::Time logicStep = sf::seconds(static_cast<float>(TetrisGame::LOGIC_STEP_SECONDS));
 	sf::Clock clock;		// Clock used to determine seconds per game loop
-	sf::Event guiEvent;		// Event for handling userInput from the GUI
+	std::atomic<bool> running{ true };
+
+	/*------------- Render Thread: draws the newest snapshot -------------*/
+
+	window.setActive(false);	// the render thread takes over the window's GL context
+	std::thread renderThread([&]() {
+		window.setActive(true);
+		TripleBuffer<RenderSnapshot>& snapshots = game.getSnapshots();
+		bool firstFrame = true;
+		while (running) {
+			snapshots.update();						// take the newest snapshot, if any
+			window.clear(sf::Color::White);			// clear the entire window
+			renderer.draw(window, snapshots.read());	// draw the game, background included (onto the window)
+			window.display();						// re-display the entire window, may block on vsync
+			if (firstFrame) {
+				firstFrame = false;
+				profile.mark("first frame");
+				profile.print(std::cout);
+			}
+		}
+		window.setActive(false);
+	});
 
 	/*---------------------- Main Game Loop ----------------------*/
+	// Events must be polled on the thread that created the window, so input & logic stay here.
 
-	while (window.isOpen()) {	
+	while (running) {	
 		float elapsedTime = clock.getElapsedTime().asSeconds(); // Get time since the last loop
 		clock.restart();		
 
 		sf::Event event;  // Window or keyboard event that has occured since the last game loop
 		while (window.pollEvent(event)) {
 			if (event.type == sf::Event::Closed) {	// Handle Close Button Clicked
-				window.close();
+				running = false;
 			}
 			else if (event.type == sf::Event::KeyPressed) {  // Handle Key Press
 				game.onKeyPressed(event);
 			}
+			else if (event.type == sf::Event::KeyReleased) {  // Handle Key Release
+				game.onKeyReleased(event);
+			}
 		}
 
-		game.processGameLoop(elapsedTime);	// handle tetris game logic in here.
+		if (assets.isAudioReady()) {				// the game is silent until its audio has loaded
+			game.attachAudio(assets.takeAudio());
+			profile.mark("attach audio");
+		}
 
-		window.clear(sf::Color::White);	// clear the entire window
-		window.draw(backgroundSprite);	// draw the background (onto the window) 				
-		game.draw();					// draw the game (onto the window)
-		window.display();				// re-display the entire window
+		game.processGameLoop(elapsedTime);	// handle tetris game logic in here, in fixed steps.
+		sf::sleep(logicStep - clock.getElapsedTime());	// wake up for the next logic step & input poll
 	}
 
+	renderThread.join();
+	window.close();
+	game.saveReplay("last.replay");		// keep the session around for bug reports
 	return 0;
 }
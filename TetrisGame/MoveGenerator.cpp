@@ -0,0 +1,109 @@
+#include "MoveGenerator.h"
+#include <algorithm>
+
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+template<int Width, int Height>
+void MoveGenerator<Width, Height>::generate(const Board& board, TetShape shape, std::vector<Placement>& placements, bool includeTucks) {
+	placements.clear();
+	found.reset();
+	generateHardDrops(board, shape, placements);
+	if (includeTucks) {
+		generateTucks(board, shape, placements);
+	}
+}
+
+// PRIVATE METHODS ---------------------------------------
+
+template<int Width, int Height>
+void MoveGenerator<Width, Height>::addPlacement(TetShape shape, int orientation, int x, int y, bool tuck, std::vector<Placement>& placements) {
+	const PieceMask& piece = PieceMask::get(shape, orientation);
+	int canonical{ getStateIndex(piece.canonicalOrientation, x + piece.canonicalDx, y + piece.canonicalDy) };
+	if (found[canonical])
+		return;
+	found[canonical] = true;
+
+	Placement placement;
+	placement.orientation = static_cast<std::uint8_t>(orientation);
+	placement.x = x;
+	placement.y = y;
+	placement.tuck = tuck;
+	placements.push_back(placement);
+}
+
+template<int Width, int Height>
+void MoveGenerator<Width, Height>::generateHardDrops(const Board& board, TetShape shape, std::vector<Placement>& placements) {
+	int tops[Width];
+	board.getColumnTops(tops);
+	const Point spawn = getSpawnLoc();
+
+	for (int orientation = 0; orientation < Tetromino::ORIENTATION_COUNT; orientation++) {
+		const PieceMask& piece = PieceMask::get(shape, orientation);
+		if (!board.fits(piece, spawn.getX(), spawn.getY()))
+			break;		// this rotation is blocked at spawn, and so are the following ones
+		if (piece.canonicalOrientation != orientation && piece.canonicalDy == 0)
+			continue;	// same cells as an earlier orientation at the same height: same drops
+
+		// Slide both ways along the spawn row, dropping at every column reached.
+		for (int direction = -1; direction <= 1; direction += 2) {
+			for (int x = direction < 0 ? spawn.getX() : spawn.getX() + 1; board.fits(piece, x, spawn.getY()); x += direction) {
+				// The lowest block of each column lands on that column's top, unless the shape
+				// starts below a top (only near a topped out stack): then step down.
+				int y{ Height };
+				bool aboveSkyline{ true };
+				for (int c = 0; c < piece.width; c++) {
+					int top{ tops[x + piece.minX + c] };
+					aboveSkyline = aboveSkyline && spawn.getY() + piece.bottoms[c] < top;
+					y = std::min(y, top - 1 - piece.bottoms[c]);
+				}
+				if (!aboveSkyline)
+					y = board.getDropY(piece, x, spawn.getY());
+				addPlacement(shape, orientation, x, y, false, placements);
+			}
+		}
+	}
+}
+
+template<int Width, int Height>
+void MoveGenerator<Width, Height>::generateTucks(const Board& board, TetShape shape, std::vector<Placement>& placements) {
+	const Point spawn = getSpawnLoc();
+	if (!board.fits(PieceMask::get(shape, 0), spawn.getX(), spawn.getY()))
+		return;
+
+	visited.reset();
+	queue.clear();
+	int start{ getStateIndex(0, spawn.getX(), spawn.getY()) };
+	visited[start] = true;
+	queue.push_back(start);
+
+	for (std::size_t next = 0; next < queue.size(); next++) {
+		int state{ queue[next] };
+		int y{ state % Y_STATES };
+		int x{ (state / Y_STATES) % X_STATES - X_OFFSET };
+		int orientation{ state / (Y_STATES * X_STATES) };
+		const PieceMask& piece = PieceMask::get(shape, orientation);
+
+		if (!board.fits(piece, x, y + 1)) {
+			addPlacement(shape, orientation, x, y, true, placements);	// hard drops are already found
+		}
+
+		const int moves[4][3] = { { orientation, x - 1, y }, { orientation, x + 1, y }, { orientation, x, y + 1 },
+			{ (orientation + 1) % Tetromino::ORIENTATION_COUNT, x, y } };
+		for (const int* move : moves) {
+			if (!board.fits(PieceMask::get(shape, move[0]), move[1], move[2]))
+				continue;
+			int moved{ getStateIndex(move[0], move[1], move[2]) };
+			if (!visited[moved]) {
+				visited[moved] = true;
+				queue.push_back(moved);
+			}
+		}
+	}
+}
+
+// EXPLICIT INSTANTIATIONS -------------------------------
+
+template class MoveGenerator<10, 19>;
+template class MoveGenerator<32, 64>;
+template class MoveGenerator<40, 100>;
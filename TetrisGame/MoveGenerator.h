@@ -0,0 +1,75 @@
+#pragma once
+#include <bitset>
+#include <cstdint>
+#include <vector>
+#include "BitBoard.h"
+#include "TetrisEngine.h"
+
+// Where a shape comes to rest. Policies only need to fill in the orientation & x of a hard drop.
+struct Placement {
+	std::uint8_t orientation{ 0 };	// Target orientation (# of clockwise rotations from spawn).
+	int x{ 0 };						// Target grid x of the shape's origin.
+	int y{ 0 };						// Grid y of the origin at rest (set by MoveGenerator).
+	bool tuck{ false };				// Only reachable with soft drops & moves under an overhang.
+};
+
+/*
+ * The MoveGenerator class template enumerates every resting placement of a shape reachable from
+ * its spawn with the engine's moves (no wall kicks):
+ *  - hard drops: each orientation reachable by rotating at spawn, slid sideways along the spawn
+ *    row, dropped straight down. Drop heights come from the board's skyline.
+ *  - tucks (optional): every other resting position found by a breadth first search over
+ *    (orientation, x, y) states with moves left, right, down & clockwise rotations.
+ * Visited states and found placements are deduplicated in bitsets indexed by state, so the search
+ * never copies shapes or allocates; orientations with the same footprint (O, S, Z, I) are reported
+ * once. A generator keeps its buffers between calls, so use one per thread.
+ */
+template<int Width, int Height>
+class MoveGenerator {
+	friend class TestSuite;
+
+public:
+	typedef BitBoard<Width, Height> Board;
+
+private:
+	static const int X_OFFSET = 2;						// Origins may lie 2 columns outside the board
+	static const int X_STATES = Width + 2 * X_OFFSET;
+	static const int Y_STATES = Height + 2;				// Origins from the spawn row down to 2 below the floor
+	static const int STATE_COUNT = Tetromino::ORIENTATION_COUNT * X_STATES * Y_STATES;
+
+	std::bitset<STATE_COUNT> visited;	// States reached by the search
+	std::bitset<STATE_COUNT> found;		// Canonical states of the placements reported
+	std::vector<int> queue;				// States to expand, allocated once
+
+public:
+	MoveGenerator() { queue.reserve(STATE_COUNT); }
+
+	// Enumerate the resting placements of a shape.
+	// @param board: The board.
+	// @param shape: The shape, starting at the spawn location in orientation 0.
+	// @param placements: Cleared, then filled with the placements; reuse it to avoid allocating.
+	// @param includeTucks: False for hard drops only.
+	void generate(const Board& board, TetShape shape, std::vector<Placement>& placements, bool includeTucks);
+
+	// Enumerate the resting placements of an engine's current shape on its board.
+	void generate(const BasicTetrisEngine<Width, Height>& engine, std::vector<Placement>& placements, bool includeTucks) {
+		generate(Board(engine.getBoard()), engine.getCurrentShape().getShape(), placements, includeTucks);
+	}
+
+	// @return: Where every shape spawns, as in BasicGameboard::getSpawnLoc().
+	static Point getSpawnLoc() { return Point(Width / 2, 0); }
+
+private:
+	static int getStateIndex(int orientation, int x, int y) {
+		return (orientation * X_STATES + x + X_OFFSET) * Y_STATES + y;
+	}
+
+	// Report a resting placement unless one covering the same cells was reported already.
+	void addPlacement(TetShape shape, int orientation, int x, int y, bool tuck, std::vector<Placement>& placements);
+
+	// Add the hard drop placements.
+	void generateHardDrops(const Board& board, TetShape shape, std::vector<Placement>& placements);
+
+	// Add the placements only reachable by soft dropping, after generateHardDrops().
+	void generateTucks(const Board& board, TetShape shape, std::vector<Placement>& placements);
+};
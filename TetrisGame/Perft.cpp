@@ -0,0 +1,172 @@
+#include "Perft.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <set>
+#include <thread>
+#include "Randomizer.h"
+#include "TetrisEngine.h"
+
+// CONSTRUCTOR -------------------------------------------
+
+Perft::Perft(const Gameboard& board, std::uint64_t seed, int maxDepth, bool includeTucks)
+	: board(board), includeTucks(includeTucks)
+{
+	Randomizer randomizer(seed);
+	for (int i = 0; i < maxDepth; i++) {
+		shapes.push_back(randomizer.nextShape());
+	}
+}
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+Perft::Result Perft::run(int depth, int threads) const {
+	assert(1 <= depth && depth <= static_cast<int>(shapes.size()));
+	if (threads <= 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	const Board root(board);
+	std::vector<Placement> rootPlacements;
+	Generator rootGenerator;
+	rootGenerator.generate(root, shapes[0], rootPlacements, includeTucks);
+
+	Result result;
+	result.depth = depth;
+	result.threads = threads;
+	result.divide.assign(rootPlacements.size(), 1);
+	std::atomic<int> nextPlacement{ 0 };
+	auto worker = [&]() {
+		Generator generator;
+		std::vector<std::vector<Placement>> placements(depth);
+		for (int i = nextPlacement++; i < static_cast<int>(rootPlacements.size()); i = nextPlacement++) {
+			const Placement& placement = rootPlacements[i];
+			Board child = root;
+			child.place(PieceMask::get(shapes[0], placement.orientation), placement.x, placement.y);
+			result.divide[i] = count(child, 1, depth - 1, generator, placements);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (int i = 1; i < threads; i++) {
+		workers.emplace_back(worker);
+	}
+	worker();
+	for (std::thread& t : workers) {
+		t.join();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	for (long long nodes : result.divide) {
+		result.nodes += nodes;
+	}
+	result.seconds = elapsed.count();
+	if (result.seconds > 0) {
+		result.nodesPerSecond = result.nodes / result.seconds;
+	}
+	return result;
+}
+
+long long Perft::runReference(int depth) const {
+	assert(1 <= depth && depth <= static_cast<int>(shapes.size()));
+	TetrisEngine engine;
+	engine.board = board;
+	return countReference(engine, 0, depth);
+}
+
+// PRIVATE METHODS ---------------------------------------
+
+long long Perft::count(const Board& board, int index, int depth, Generator& generator, std::vector<std::vector<Placement>>& placements) const {
+	if (depth == 0)
+		return 1;
+
+	std::vector<Placement>& moves = placements[index];
+	generator.generate(board, shapes[index], moves, includeTucks);
+	if (depth == 1)
+		return static_cast<long long>(moves.size());	// the leaves don't need placing
+
+	long long nodes{ 0 };
+	for (const Placement& placement : moves) {
+		Board child = board;
+		child.place(PieceMask::get(shapes[index], placement.orientation), placement.x, placement.y);
+		nodes += count(child, index + 1, depth - 1, generator, placements);
+	}
+	return nodes;
+}
+
+long long Perft::countReference(TetrisEngine& engine, int index, int depth) const {
+	if (depth == 0)
+		return 1;
+
+	GridTetromino spawn;
+	spawn.setShape(shapes[index]);
+	spawn.setGridLoc(engine.board.getSpawnLoc());
+	if (!engine.isPositionLegal(spawn))
+		return 0;
+
+	// Find the resting shapes, one per set of cells covered.
+	typedef std::vector<int> Cells;
+	std::set<Cells> seen;
+	std::vector<GridTetromino> resting;
+	auto addResting = [&](const GridTetromino& shape) {
+		Cells cells;
+		for (const Point& p : shape.getBlockLocsMappedToGrid()) {
+			cells.push_back(p.getY() * Gameboard::MAX_X + p.getX());
+		}
+		std::sort(cells.begin(), cells.end());
+		if (seen.insert(cells).second)
+			resting.push_back(shape);
+	};
+
+	// hard drops: rotate at spawn, slide, drop
+	GridTetromino rotated = spawn;
+	for (int orientation = 0; orientation < Tetromino::ORIENTATION_COUNT && engine.isPositionLegal(rotated); orientation++) {
+		for (int direction = -1; direction <= 1; direction += 2) {
+			for (GridTetromino slid = rotated; engine.isPositionLegal(slid); slid.move(direction, 0)) {
+				GridTetromino dropped = slid;
+				engine.drop(dropped);
+				addResting(dropped);
+			}
+		}
+		rotated.rotateClockwise();
+	}
+
+	// tucks: every resting position reachable with single moves & rotations
+	if (includeTucks) {
+		std::set<std::vector<int>> visited{ { 0, spawn.getGridLoc().getX(), spawn.getGridLoc().getY() } };
+		std::vector<GridTetromino> queue{ spawn };
+		for (std::size_t next = 0; next < queue.size(); next++) {
+			GridTetromino below = queue[next];
+			below.move(0, 1);
+			if (!engine.isPositionLegal(below))
+				addResting(queue[next]);
+			const int moves[4][2] = { { -1, 0 }, { 1, 0 }, { 0, 1 }, { 0, 0 } };	// left, right, down, rotate
+			for (const int* move : moves) {
+				GridTetromino moved = queue[next];
+				moved.move(move[0], move[1]);
+				if (move[0] == 0 && move[1] == 0)
+					moved.rotateClockwise();
+				std::vector<int> state{ moved.getOrientation(), moved.getGridLoc().getX(), moved.getGridLoc().getY() };
+				if (engine.isPositionLegal(moved) && visited.insert(state).second)
+					queue.push_back(moved);
+			}
+		}
+	}
+
+	if (depth == 1)
+		return static_cast<long long>(resting.size());
+
+	long long nodes{ 0 };
+	const Gameboard parent = engine.board;
+	for (const GridTetromino& shape : resting) {
+		for (const Point& p : shape.getBlockLocsMappedToGrid()) {
+			engine.board.setContent(p, static_cast<int>(shape.getColor()));
+		}
+		engine.board.removeCompletedRows();
+		nodes += countReference(engine, index + 1, depth - 1);
+		engine.board = parent;
+	}
+	return nodes;
+}
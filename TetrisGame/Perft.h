@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Gameboard.h"
+#include "MoveGenerator.h"
+#include "Tetromino.h"
+
+/*
+ * The Perft class counts the placement sequences of the next N shapes of a seeded game, starting
+ * from a board, the way chess engines count move sequences with perft. A sequence ends early if
+ * a shape can't spawn; boards reached by several sequences are counted once per sequence.
+ * Node counts of known positions catch any change to the collision or line clear code, and
+ * nodes/sec is a single throughput number for the move generation & placement path.
+ * run() walks BitBoards with the MoveGenerator, optionally splitting the first shape's placements
+ * across threads; runReference() walks Gameboards with the engine's own collision checks
+ * (isPositionLegal, drop) and removeCompletedRows(), so both must agree.
+ */
+class Perft {
+	friend class TestSuite;
+
+public:
+	typedef BitBoard<Gameboard::MAX_X, Gameboard::MAX_Y> Board;
+	typedef MoveGenerator<Gameboard::MAX_X, Gameboard::MAX_Y> Generator;
+
+	struct Result {
+		int depth{ 0 };
+		int threads{ 0 };
+		long long nodes{ 0 };				// # of placement sequences of depth shapes.
+		std::vector<long long> divide;		// Nodes under each placement of the first shape.
+		double seconds{ 0 };
+		double nodesPerSecond{ 0 };
+	};
+
+private:
+	Gameboard board;				// The starting board
+	std::vector<TetShape> shapes;	// The shapes to place, in order
+	bool includeTucks;				// Count soft drop tucks as well as hard drops
+
+public:
+	// Constructor
+	// @param board: The starting board.
+	// @param seed: Seed of the game dealing the shapes, as in TetrisEngine.
+	// @param maxDepth: # of shapes dealt, the deepest count possible.
+	// @param includeTucks: False to only count hard drops.
+	Perft(const Gameboard& board, std::uint64_t seed, int maxDepth, bool includeTucks);
+
+	// Count the placement sequences of the next shapes with the MoveGenerator.
+	// @param depth: # of shapes to place, at most maxDepth.
+	// @param threads: # of threads sharing the first shape's placements, 0 for one per core.
+	// @return: The counts & throughput.
+	Result run(int depth, int threads = 1) const;
+
+	// Count the same sequences with the engine's collision & line clear code. Much slower.
+	// @param depth: # of shapes to place, at most maxDepth.
+	// @return: The # of placement sequences.
+	long long runReference(int depth) const;
+
+private:
+	// Count the sequences below a board.
+	// @param board: The board before placing shapes[index].
+	// @param index: The shape to place next.
+	// @param depth: # of shapes left to place.
+	// @param generator: The calling thread's generator.
+	// @param placements: The calling thread's placement buffers, one per shape.
+	long long count(const Board& board, int index, int depth, Generator& generator, std::vector<std::vector<Placement>>& placements) const;
+
+	// Count the sequences below a board with the engine's collision & line clear code.
+	// @param engine: Holds the board before placing shapes[index].
+	long long countReference(TetrisEngine& engine, int index, int depth) const;
+};
@@ -14,10 +14,10 @@ private:
     int y{};  
 public:
     // Constructor with x and y input
-    Point(int x, int y) : x(x), y(y) {};
+    constexpr Point(int x, int y) : x(x), y(y) {};
 
     // Default Constructor
-    Point() : Point(0, 0) {};
+    constexpr Point() : Point(0, 0) {};
 
     // Points are equal if they have the same x and y values.
     bool operator==(const Point& other) const {
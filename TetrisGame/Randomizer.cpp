@@ -0,0 +1,83 @@
+#include "Randomizer.h"
+#include <cassert>
+#include <utility>
+
+// -------------- PCG32 -------------- //
+
+void Pcg32::seed(std::uint64_t seed, std::uint64_t stream) {
+	state = 0;
+	increment = (stream << 1) | 1;
+	next();
+	state += seed;
+	next();
+}
+
+std::uint32_t Pcg32::next() {
+	std::uint64_t oldState{ state };
+	state = oldState * 6364136223846793005ULL + increment;
+	std::uint32_t xorShifted = static_cast<std::uint32_t>(((oldState >> 18) ^ oldState) >> 27);
+	std::uint32_t rotation = static_cast<std::uint32_t>(oldState >> 59);
+	return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+}
+
+std::uint32_t Pcg32::nextBelow(std::uint32_t bound) {
+	assert(bound > 0);
+	// Reject the low values that would make the modulo biased.
+	std::uint32_t threshold = (0u - bound) % bound;
+	for (;;) {
+		std::uint32_t r{ next() };
+		if (r >= threshold)
+			return r % bound;
+	}
+}
+
+// -------------- RANDOMIZER -------------- //
+
+Randomizer::Randomizer(std::uint64_t seed) {
+	reseed(seed);
+}
+
+void Randomizer::reseed(std::uint64_t seed) {
+	this->seed = seed;
+	shapeRng.seed(seed, 1);
+	colorRng.seed(seed, 2);
+	bagIndex = BAG_SIZE;
+	previewHead = 0;
+	previewCount = 0;
+}
+
+TetShape Randomizer::nextShape() {
+	if (previewCount == 0)
+		dealIntoPreview();
+
+	TetShape shape{ preview[previewHead] };
+	previewHead = (previewHead + 1) % PREVIEW_CAPACITY;
+	previewCount--;
+	return shape;
+}
+
+TetShape Randomizer::peekShape(int index) const {
+	assert(0 <= index && index < PREVIEW_CAPACITY);
+	while (previewCount <= index)
+		dealIntoPreview();
+
+	return preview[(previewHead + index) % PREVIEW_CAPACITY];
+}
+
+TetColor Randomizer::nextColor() {
+	return static_cast<TetColor>(colorRng.nextBelow(static_cast<std::uint32_t>(TetColor::COUNT)));
+}
+
+void Randomizer::dealIntoPreview() const {
+	assert(previewCount < PREVIEW_CAPACITY);
+	if (bagIndex == BAG_SIZE) {
+		// Fisher-Yates shuffle of a fresh bag, using our own generator so every platform agrees.
+		for (int i = 0; i < BAG_SIZE; i++)
+			bag[i] = static_cast<TetShape>(i);
+		for (int i = BAG_SIZE - 1; i > 0; i--)
+			std::swap(bag[i], bag[shapeRng.nextBelow(static_cast<std::uint32_t>(i + 1))]);
+		bagIndex = 0;
+	}
+	preview[(previewHead + previewCount) % PREVIEW_CAPACITY] = bag[bagIndex++];
+	previewCount++;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "Tetromino.h"
+
+/*
+ * Pcg32 is a small, fast PRNG (PCG-XSH-RR, 64-bit state, 32-bit output). Its output only depends
+ * on the seed & stream, never on the platform or standard library, so games are reproducible.
+ */
+class Pcg32 {
+private:
+	std::uint64_t state{ 0 };
+	std::uint64_t increment{ 1 };  // Selects the stream, always odd.
+
+public:
+	// Constructor
+	// @param seed: The starting state.
+	// @param stream: Selects one of 2^63 independent sequences for the same seed.
+	Pcg32(std::uint64_t seed = 0, std::uint64_t stream = 0) { this->seed(seed, stream); }
+
+	// Restart the generator.
+	// @param seed: The starting state.
+	// @param stream: Selects one of 2^63 independent sequences for the same seed.
+	void seed(std::uint64_t seed, std::uint64_t stream);
+
+	// Get the next 32 random bits.
+	std::uint32_t next();
+
+	// Get a uniformly distributed number in [0, bound).
+	// @param bound: The exclusive upper bound, greater than 0.
+	std::uint32_t nextBelow(std::uint32_t bound);
+};
+
+/*
+ * The Randomizer class deals the pieces of a single game. Shapes come out of a shuffled 7-bag
+ * (every shape once per bag) and can be previewed any number of pieces ahead; colors come from
+ * an independent stream so previewing never changes them. All state is held in fixed arrays, so
+ * each game owns its Randomizer and equal seeds deal equal games on every platform.
+ */
+class Randomizer {
+	friend class TestSuite;
+
+public:
+	static const int BAG_SIZE = static_cast<int>(TetShape::COUNT);	// Shapes in a bag (one of each)
+	static const int PREVIEW_CAPACITY = 64;							// Max # of shapes that can be previewed
+
+private:
+	std::uint64_t seed;				// The seed the randomizer was started with.
+	mutable Pcg32 shapeRng;			// Stream used to shuffle the bags.
+	Pcg32 colorRng;					// Stream used to pick colors.
+
+	mutable std::array<TetShape, BAG_SIZE> bag;					// The current shuffled bag.
+	mutable int bagIndex;										// Next shape to take from the bag.
+	mutable std::array<TetShape, PREVIEW_CAPACITY> preview;		// Ring buffer of dealt but unused shapes.
+	mutable int previewHead;									// Index of the next shape in preview.
+	mutable int previewCount;									// # of shapes in preview.
+
+public:
+	// Constructor
+	// @param seed: The seed of the game, equal seeds deal equal pieces.
+	explicit Randomizer(std::uint64_t seed = 0);
+
+	// Restart the randomizer from a seed, discarding the bag and the preview.
+	// @param seed: The seed of the game.
+	void reseed(std::uint64_t seed);
+
+	// Get the seed the randomizer was started with.
+	std::uint64_t getSeed() const { return seed; }
+
+	// Take the next shape of the sequence.
+	TetShape nextShape();
+
+	// Look at an upcoming shape without taking it.
+	// @param index: 0 is the shape nextShape() will return, 1 the one after, ...
+	//               must be less than PREVIEW_CAPACITY.
+	TetShape peekShape(int index) const;
+
+	// Pick a random color.
+	TetColor nextColor();
+
+private:
+	// Deal the next shape from the bag into the preview, shuffling a new bag if needed.
+	void dealIntoPreview() const;
+};
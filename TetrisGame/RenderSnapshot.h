@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include "TetrisEngine.h"
+
+/*
+ * Everything the renderer needs to draw one frame, copied out of a TetrisEngine after its
+ * logic steps. A plain value, so it can be handed to the render thread through a TripleBuffer.
+ */
+struct RenderSnapshot {
+	Gameboard board;				// Locked blocks.
+	GridTetromino currentShape;
+	GridTetromino ghostShape;
+	GridTetromino nextShape;
+	int score{ 0 };
+	double tickProgress{ 0.0 };		// TetrisEngine::getTickProgress()
+	std::uint32_t boardVersion{ 0 };	// Changes whenever the board changed (lock, line clear, reset).
+
+	// Copy the state of an engine.
+	// @param engine: The engine to copy.
+	// @param boardVersion: The version of the engine's board.
+	void capture(const TetrisEngine& engine, std::uint32_t boardVersion) {
+		board = engine.getBoard();
+		currentShape = engine.getCurrentShape();
+		ghostShape = engine.getGhostShape();
+		nextShape = engine.getNextShape();
+		score = engine.getScore();
+		tickProgress = engine.getTickProgress();
+		this->boardVersion = boardVersion;
+	}
+};
@@ -0,0 +1,223 @@
+#include "Replay.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+
+namespace {
+	const char FILE_MAGIC[4] = { 'T', 'R', 'P', 'L' };
+	const int KIND_BITS = 3;
+	const std::uint32_t KIND_MASK = (1 << KIND_BITS) - 1;
+
+	static_assert(static_cast<int>(ReplayEventKind::COUNT) <= (1 << KIND_BITS), "ReplayEventKind must fit in KIND_BITS");
+
+	void writeU32(std::ofstream& out, std::uint32_t value) {
+		for (int i = 0; i < 4; i++)
+			out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+
+	void writeU64(std::ofstream& out, std::uint64_t value) {
+		for (int i = 0; i < 8; i++)
+			out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+
+	bool readU32(std::ifstream& in, std::uint32_t& value) {
+		unsigned char buf[4];
+		if (!in.read(reinterpret_cast<char*>(buf), 4))
+			return false;
+		value = 0;
+		for (int i = 0; i < 4; i++)
+			value |= static_cast<std::uint32_t>(buf[i]) << (8 * i);
+		return true;
+	}
+
+	bool readU64(std::ifstream& in, std::uint64_t& value) {
+		unsigned char buf[8];
+		if (!in.read(reinterpret_cast<char*>(buf), 8))
+			return false;
+		value = 0;
+		for (int i = 0; i < 8; i++)
+			value |= static_cast<std::uint64_t>(buf[i]) << (8 * i);
+		return true;
+	}
+}
+
+// -------------- REPLAY -------------- //
+
+void Replay::record(ReplayEventKind kind, double gameSeconds) {
+	std::uint32_t timeMs = static_cast<std::uint32_t>(std::llround(gameSeconds * 1000.0));
+	if (kind == ReplayEventKind::Tick) {
+		pendingTicks++;
+		pendingTickTimeMs = timeMs;
+		return;
+	}
+
+	flush();
+	write(kind, timeMs, 0);
+	eventCount++;
+}
+
+void Replay::flush() {
+	if (pendingTicks > 0) {
+		write(ReplayEventKind::Tick, pendingTickTimeMs, pendingTicks);
+		eventCount += pendingTicks;
+		pendingTicks = 0;
+	}
+}
+
+void Replay::restart(std::uint64_t seed) {
+	this->seed = seed;
+	bytes.clear();
+	eventCount = 0;
+	lastTimeMs = 0;
+	pendingTicks = 0;
+	pendingTickTimeMs = 0;
+}
+
+bool Replay::saveToFile(const std::string& path) {
+	flush();
+	std::ofstream out(path, std::ios::binary);
+	if (!out)
+		return false;
+
+	out.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+	writeU32(out, FILE_VERSION);
+	writeU64(out, seed);
+	writeU32(out, eventCount);
+	writeU32(out, static_cast<std::uint32_t>(bytes.size()));
+	out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+	return static_cast<bool>(out);
+}
+
+bool Replay::loadFromFile(const std::string& path) {
+	std::ifstream in(path, std::ios::binary);
+	char magic[sizeof(FILE_MAGIC)];
+	std::uint32_t version, count, size;
+	std::uint64_t fileSeed;
+	if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), FILE_MAGIC))
+		return false;
+	if (!readU32(in, version) || version != FILE_VERSION)
+		return false;
+	if (!readU64(in, fileSeed) || !readU32(in, count) || !readU32(in, size))
+		return false;
+
+	// Don't trust the size before allocating: a truncated or corrupt file can claim up to 4 GiB.
+	const std::streampos dataStart{ in.tellg() };
+	in.seekg(0, std::ios::end);
+	const std::streamoff available{ in.tellg() - dataStart };
+	in.seekg(dataStart);
+	if (!in || available < 0 || static_cast<std::uint64_t>(available) < size)
+		return false;
+
+	std::vector<std::uint8_t> fileBytes(size);
+	if (!in.read(reinterpret_cast<char*>(fileBytes.data()), size))
+		return false;
+
+	restart(fileSeed);
+	bytes.swap(fileBytes);
+	eventCount = count;
+	return true;
+}
+
+void Replay::write(ReplayEventKind kind, std::uint32_t timeMs, std::uint32_t ticks) {
+	assert(timeMs >= lastTimeMs);
+	std::uint64_t delta{ timeMs - lastTimeMs };
+	writeVarint((delta << KIND_BITS) | static_cast<std::uint64_t>(kind));
+	if (kind == ReplayEventKind::Tick)
+		writeVarint(ticks - 1);
+	lastTimeMs = timeMs;
+}
+
+void Replay::writeVarint(std::uint64_t value) {
+	while (value >= 0x80) {
+		bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	bytes.push_back(static_cast<std::uint8_t>(value));
+}
+
+// -------------- REPLAY PLAYER -------------- //
+
+ReplayPlayer::ReplayPlayer(Replay& replay)
+	: replay(replay), engine(replay.getSeed())
+{
+	replay.flush();
+	engine.takeEvents();
+	keyframes.push_back({ cursor, engine });
+}
+
+bool ReplayPlayer::step(ReplayEvent* event) {
+	ReplayEventKind kind;
+	if (cursor.ticksLeft > 0) {
+		kind = ReplayEventKind::Tick;
+		cursor.ticksLeft--;
+	}
+	else {
+		if (cursor.offset >= replay.bytes.size())
+			return false;
+		std::uint64_t header, ticks{ 0 };
+		if (!readVarint(header)) {
+			malformed = true;
+			return false;
+		}
+		kind = static_cast<ReplayEventKind>(header & KIND_MASK);
+		if (kind == ReplayEventKind::Tick && !readVarint(ticks)) {
+			malformed = true;
+			return false;
+		}
+		cursor.timeMs += static_cast<std::uint32_t>(header >> KIND_BITS);
+		cursor.ticksLeft = static_cast<std::uint32_t>(ticks);
+	}
+
+	switch (kind) {
+		case ReplayEventKind::RotateClockwise: engine.handleInput(GameInput::RotateClockwise); break;
+		case ReplayEventKind::MoveLeft:        engine.handleInput(GameInput::MoveLeft); break;
+		case ReplayEventKind::MoveRight:       engine.handleInput(GameInput::MoveRight); break;
+		case ReplayEventKind::SoftDrop:        engine.handleInput(GameInput::SoftDrop); break;
+		case ReplayEventKind::HardDrop:        engine.handleInput(GameInput::HardDrop); break;
+		case ReplayEventKind::Tick:            engine.tick(); break;
+		case ReplayEventKind::ShapePlaced:     engine.processPlacedShape(); break;
+		case ReplayEventKind::Reset:           engine.reset(); break;
+		default: assert(false && "Corrupt replay event"); break;
+	}
+	engine.takeEvents();
+	cursor.eventIndex++;
+
+	if (kind == ReplayEventKind::ShapePlaced) {
+		cursor.placements++;
+		if (cursor.placements % KEYFRAME_INTERVAL == 0 && cursor.placements / KEYFRAME_INTERVAL == keyframes.size())
+			keyframes.push_back({ cursor, engine });
+	}
+
+	if (event) {
+		event->kind = kind;
+		event->timeMs = cursor.timeMs;
+	}
+	return true;
+}
+
+void ReplayPlayer::playToEnd() {
+	while (step());
+}
+
+void ReplayPlayer::seekToPlacement(std::uint32_t placements) {
+	// Resume from the closest keyframe at or before the target, unless we're already closer.
+	std::size_t keyframeIdx = std::min<std::size_t>(placements / KEYFRAME_INTERVAL, keyframes.size() - 1);
+	const Keyframe& keyframe = keyframes[keyframeIdx];
+	if (placements < cursor.placements || keyframe.cursor.placements > cursor.placements) {
+		cursor = keyframe.cursor;
+		engine = keyframe.engine;
+	}
+	while (cursor.placements < placements && step());
+}
+
+bool ReplayPlayer::readVarint(std::uint64_t& value) {
+	value = 0;
+	for (int shift = 0; shift < 64 && cursor.offset < replay.bytes.size(); shift += 7) {
+		std::uint8_t byte{ replay.bytes[cursor.offset++] };
+		value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;		// ran off the end, or more than 10 bytes
+}
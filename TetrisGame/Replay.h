@@ -0,0 +1,152 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "TetrisEngine.h"
+
+// Everything that changes a TetrisEngine's state besides its seed. Stored in 3 bits.
+enum class ReplayEventKind : std::uint8_t {
+	RotateClockwise,	// GameInput::RotateClockwise
+	MoveLeft,			// GameInput::MoveLeft
+	MoveRight,			// GameInput::MoveRight
+	SoftDrop,			// GameInput::SoftDrop
+	HardDrop,			// GameInput::HardDrop
+	Tick,				// Gravity tick
+	ShapePlaced,		// Placed shape processed: spawn, line clears or game over
+	Reset,				// New game after a game over
+	COUNT
+};
+
+static_assert(static_cast<int>(GameInput::RotateClockwise) == static_cast<int>(ReplayEventKind::RotateClockwise) &&
+	static_cast<int>(GameInput::HardDrop) == static_cast<int>(ReplayEventKind::HardDrop),
+	"GameInput values are recorded as ReplayEventKind values");
+
+// A decoded replay event.
+struct ReplayEvent {
+	ReplayEventKind kind;
+	std::uint32_t timeMs;	// Game time of the event in milliseconds.
+};
+
+/*
+ * The Replay class stores a game as its seed plus the stream of events that happened in the
+ * engine. Events are varint encoded as (delta milliseconds << 3 | kind); consecutive gravity ticks
+ * are merged into one run, so a piece typically costs a handful of bytes.
+ * A TetrisEngine records into a Replay set with TetrisEngine::setRecorder().
+ */
+class Replay {
+	friend class TestSuite;
+	friend class ReplayPlayer;
+
+public:
+	static const std::uint32_t FILE_VERSION = 1;
+
+private:
+	std::uint64_t seed;					// Seed of the recorded engine.
+	std::vector<std::uint8_t> bytes;	// Encoded event stream.
+	std::uint32_t eventCount{ 0 };		// # of events in the stream (a tick run counts each tick).
+
+	// Recording state
+	std::uint32_t lastTimeMs{ 0 };		// Time of the last encoded event.
+	std::uint32_t pendingTicks{ 0 };	// Ticks waiting to be written as one run.
+	std::uint32_t pendingTickTimeMs{ 0 };	// Time of the last pending tick.
+
+public:
+	// Constructor
+	// @param seed: Seed of the engine being recorded.
+	explicit Replay(std::uint64_t seed = 0) : seed(seed) {}
+
+	// Append an event.
+	// @param kind: What happened.
+	// @param gameSeconds: Game time of the event in seconds, never decreasing.
+	void record(ReplayEventKind kind, double gameSeconds);
+
+	// Write out any pending tick run. Called by saveToFile() & ReplayPlayer.
+	void flush();
+
+	// Forget all events and start recording a game with a new seed.
+	// @param seed: Seed of the engine being recorded.
+	void restart(std::uint64_t seed);
+
+	// Write the replay to a binary file.
+	// @return: True if the file was written.
+	bool saveToFile(const std::string& path);
+
+	// Read a replay written by saveToFile().
+	// @return: True if the file was read and is a valid replay.
+	bool loadFromFile(const std::string& path);
+
+	std::uint64_t getSeed() const { return seed; }
+	std::uint32_t getEventCount() const { return eventCount + pendingTicks; }
+	std::size_t getByteCount() const { return bytes.size(); }
+
+private:
+	// Encode one event (or a tick run) at the end of the stream.
+	void write(ReplayEventKind kind, std::uint32_t timeMs, std::uint32_t ticks);
+
+	// Append an unsigned LEB128 varint.
+	void writeVarint(std::uint64_t value);
+};
+
+/*
+ * The ReplayPlayer class re-runs a Replay on a headless TetrisEngine at full CPU speed, without
+ * looking at the wall clock. Every KEYFRAME_INTERVAL placed shapes it keeps a copy of the engine,
+ * so seeking back only replays from the nearest keyframe.
+ */
+class ReplayPlayer {
+public:
+	static const int KEYFRAME_INTERVAL = 64;	// Placed shapes between keyframes
+
+private:
+	// Position in the event stream, enough to resume decoding.
+	struct Cursor {
+		std::size_t offset{ 0 };			// Byte offset of the next encoded event.
+		std::uint32_t eventIndex{ 0 };		// # of events applied.
+		std::uint32_t timeMs{ 0 };			// Time of the last decoded event.
+		std::uint32_t ticksLeft{ 0 };		// Ticks left in the current tick run.
+		std::uint32_t placements{ 0 };		// # of ShapePlaced events applied.
+	};
+
+	struct Keyframe {
+		Cursor cursor;
+		TetrisEngine engine;
+	};
+
+	const Replay& replay;
+	TetrisEngine engine;
+	Cursor cursor;
+	std::vector<Keyframe> keyframes;
+	bool malformed{ false };		// Set when an event couldn't be decoded
+
+public:
+	// Constructor
+	// @param replay: The replay to play, must outlive the player. Pending ticks are flushed.
+	explicit ReplayPlayer(Replay& replay);
+
+	// Apply the next event to the engine.
+	// @param event: Set to the applied event if not null.
+	// @return: False once the end of the replay (or a malformed event) is reached.
+	bool step(ReplayEvent* event = nullptr);
+
+	// Apply every remaining event.
+	void playToEnd();
+
+	// Move to the point just after a given # of placed shapes (or the end of the replay).
+	// @param placements: The # of ShapePlaced events to have applied.
+	void seekToPlacement(std::uint32_t placements);
+
+	const TetrisEngine& getEngine() const { return engine; }
+	std::uint32_t getEventIndex() const { return cursor.eventIndex; }
+	std::uint32_t getPlacementCount() const { return cursor.placements; }
+	std::uint32_t getTimeMs() const { return cursor.timeMs; }
+	bool isAtEnd() const { return cursor.ticksLeft == 0 && cursor.offset >= replay.bytes.size(); }
+
+	// @return: True if playback stopped at an event that couldn't be decoded.
+	bool isMalformed() const { return malformed; }
+
+private:
+	// Read an unsigned LEB128 varint at the cursor.
+	// @param value: Set to the decoded value.
+	// @return: False if the stream ends inside the varint or it's longer than 64 bits allow.
+	bool readVarint(std::uint64_t& value);
+};
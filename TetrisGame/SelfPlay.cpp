@@ -0,0 +1,144 @@
+#include "SelfPlay.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// -------------- RANDOM POLICY -------------- //
+
+Placement RandomPolicy::choosePlacement(const TetrisEngine& /*engine*/) {
+	Placement placement;
+	placement.orientation = static_cast<std::uint8_t>(rng.nextBelow(Tetromino::ORIENTATION_COUNT));
+	placement.x = static_cast<int>(rng.nextBelow(Gameboard::MAX_X));
+	return placement;
+}
+
+// -------------- HEURISTIC POLICY -------------- //
+
+Placement HeuristicPolicy::choosePlacement(const TetrisEngine& engine) {
+	const Generator::Board board(engine.getBoard());
+	const Features features(board);
+	TetShape shape{ engine.getCurrentShape().getShape() };
+	generator.generate(board, shape, placements, false);	// applyPlacement() can't tuck
+
+	Placement best;
+	double bestScore{ 0 };
+	for (const Placement& placement : placements) {
+		Generator::Board child = board;
+		Features childFeatures = features;
+		childFeatures.place(child, PieceMask::get(shape, placement.orientation), placement.x, placement.y);
+		double score{ childFeatures.evaluate(weights) };
+		if (&placement == &placements.front() || score > bestScore) {
+			best = placement;
+			bestScore = score;
+		}
+	}
+	return best;
+}
+
+// -------------- SELF PLAY RUNNER -------------- //
+
+SelfPlayRunner::SelfPlayRunner(const Config& config, PolicyFactory makePolicy)
+	: config(config), makePolicy(makePolicy)
+{
+	this->config.games = std::max(0, this->config.games);
+	if (this->config.threads <= 0) {
+		this->config.threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+}
+
+SelfPlayRunner::Stats SelfPlayRunner::run() {
+	results.assign(config.games, GameResult());
+	std::atomic<int> nextGame{ 0 };
+	auto worker = [&]() {
+		for (int game = nextGame++; game < config.games; game = nextGame++) {
+			std::uint64_t seed{ config.baseSeed + static_cast<std::uint64_t>(game) };
+			std::unique_ptr<PlacementPolicy> policy = makePolicy(seed);
+			results[game] = playGame(seed, *policy, config.maxPieces);
+		}
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+	for (int i = 1; i < config.threads; i++) {
+		workers.emplace_back(worker);
+	}
+	worker();
+	for (std::thread& t : workers) {
+		t.join();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	Stats stats;
+	stats.games = config.games;
+	stats.threads = config.threads;
+	stats.wallSeconds = elapsed.count();
+	std::vector<double> scores, lengths;
+	for (const GameResult& result : results) {
+		stats.totalPieces += result.piecesPlaced;
+		stats.totalLines += result.linesCleared;
+		scores.push_back(result.score);
+		lengths.push_back(result.piecesPlaced);
+	}
+	if (stats.wallSeconds > 0) {
+		stats.piecesPerSecond = stats.totalPieces / stats.wallSeconds;
+		stats.linesPerSecond = stats.totalLines / stats.wallSeconds;
+	}
+	stats.score = summarize(scores);
+	stats.gameLength = summarize(lengths);
+	return stats;
+}
+
+GameResult SelfPlayRunner::playGame(std::uint64_t seed, PlacementPolicy& policy, int maxPieces) {
+	TetrisEngine engine(seed);
+	while (engine.getGameLoopState() == GameLoopState::Playing && engine.getPiecesPlaced() < maxPieces) {
+		applyPlacement(engine, policy.choosePlacement(engine));
+	}
+
+	GameResult result;
+	result.seed = seed;
+	result.score = engine.getScore();
+	result.piecesPlaced = engine.getPiecesPlaced();
+	result.linesCleared = engine.getLinesCleared();
+	result.toppedOut = engine.getGameLoopState() != GameLoopState::Playing;
+	return result;
+}
+
+void SelfPlayRunner::applyPlacement(TetrisEngine& engine, const Placement& placement) {
+	for (int i = 0; i < Tetromino::ORIENTATION_COUNT && engine.getCurrentShape().getOrientation() != placement.orientation; i++) {
+		engine.handleInput(GameInput::RotateClockwise);
+	}
+
+	GameInput move{ placement.x < engine.getCurrentShape().getGridLoc().getX() ? GameInput::MoveLeft : GameInput::MoveRight };
+	for (int x = engine.getCurrentShape().getGridLoc().getX(); x != placement.x; ) {
+		engine.handleInput(move);
+		int movedX{ engine.getCurrentShape().getGridLoc().getX() };
+		if (movedX == x) {
+			break;	// blocked
+		}
+		x = movedX;
+	}
+
+	engine.handleInput(GameInput::HardDrop);
+	engine.step(0.0);	// process the placed shape without advancing gravity
+}
+
+SelfPlayRunner::Distribution SelfPlayRunner::summarize(std::vector<double> values) {
+	Distribution dist;
+	if (values.empty()) {
+		return dist;
+	}
+	std::sort(values.begin(), values.end());
+	auto percentile = [&](double p) { return values[static_cast<std::size_t>(p * (values.size() - 1))]; };
+	double sum{ 0 };
+	for (double v : values) {
+		sum += v;
+	}
+	dist.min = values.front();
+	dist.max = values.back();
+	dist.mean = sum / values.size();
+	dist.p50 = percentile(0.50);
+	dist.p90 = percentile(0.90);
+	dist.p99 = percentile(0.99);
+	return dist;
+}
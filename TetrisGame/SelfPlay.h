@@ -0,0 +1,130 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "BoardFeatures.h"
+#include "MoveGenerator.h"
+#include "TetrisEngine.h"
+
+/*
+ * A PlacementPolicy decides where each shape of a self-played game goes. Each game gets its own
+ * policy instance from a PolicyFactory, so policies may keep state without locking.
+ */
+class PlacementPolicy {
+public:
+	virtual ~PlacementPolicy() = default;
+
+	// Pick a placement for the engine's current shape.
+	// @param engine: The game being played, in the Playing state.
+	// @return: The orientation & column to drop the current shape at.
+	virtual Placement choosePlacement(const TetrisEngine& engine) = 0;
+};
+
+// Creates the policy for one game.
+// @param seed: Seed of the game, for policies that need their own randomness.
+typedef std::function<std::unique_ptr<PlacementPolicy>(std::uint64_t seed)> PolicyFactory;
+
+// Drops every shape at a random orientation & column. A baseline for better policies.
+class RandomPolicy : public PlacementPolicy {
+private:
+	Pcg32 rng;
+
+public:
+	explicit RandomPolicy(std::uint64_t seed) { rng.seed(seed, 3); }
+	Placement choosePlacement(const TetrisEngine& engine) override;
+};
+
+// Drops every shape at the hard drop placement with the best linear evaluation of the board it
+// leaves. Deterministic: the seed is unused.
+class HeuristicPolicy : public PlacementPolicy {
+public:
+	typedef MoveGenerator<Gameboard::MAX_X, Gameboard::MAX_Y> Generator;
+	typedef BoardFeatures<Gameboard::MAX_X, Gameboard::MAX_Y> Features;
+
+private:
+	EvaluationWeights weights;
+	Generator generator;
+	std::vector<Placement> placements;	// Candidates, reused between calls
+
+public:
+	explicit HeuristicPolicy(const EvaluationWeights& weights = EvaluationWeights()) : weights(weights) {}
+	Placement choosePlacement(const TetrisEngine& engine) override;
+};
+
+// Outcome of one self-played game.
+struct GameResult {
+	std::uint64_t seed{ 0 };
+	int score{ 0 };
+	int piecesPlaced{ 0 };
+	int linesCleared{ 0 };
+	bool toppedOut{ false };	// False if the game was stopped at the piece limit.
+};
+
+/*
+ * The SelfPlayRunner plays many independent headless games across a set of worker threads.
+ * Workers pull the next game index from a shared counter, so faster games don't leave threads
+ * idle. Game i always uses seed baseSeed + i, so results don't depend on the thread count.
+ */
+class SelfPlayRunner {
+	friend class TestSuite;
+
+public:
+	struct Config {
+		int games{ 1000 };				// # of games to play.
+		int threads{ 0 };				// # of worker threads, 0 for one per core.
+		std::uint64_t baseSeed{ 1 };	// Seed of the first game.
+		int maxPieces{ 100000 };		// Stop a game after this many pieces (for policies that never top out).
+	};
+
+	// Min/mean/percentiles of a per-game quantity.
+	struct Distribution {
+		double min{ 0 }, mean{ 0 }, p50{ 0 }, p90{ 0 }, p99{ 0 }, max{ 0 };
+	};
+
+	struct Stats {
+		int games{ 0 };
+		int threads{ 0 };
+		double wallSeconds{ 0 };
+		long long totalPieces{ 0 };
+		long long totalLines{ 0 };
+		double piecesPerSecond{ 0 };
+		double linesPerSecond{ 0 };
+		Distribution score;
+		Distribution gameLength;	// In pieces placed.
+	};
+
+private:
+	Config config;
+	PolicyFactory makePolicy;
+	std::vector<GameResult> results;	// Indexed by game, filled in by run().
+
+public:
+	// Constructor
+	// @param config: How many games to play and on how many threads.
+	// @param makePolicy: Creates the placement policy of each game.
+	SelfPlayRunner(const Config& config, PolicyFactory makePolicy);
+
+	// Play every game and summarize them.
+	// @return: Throughput & distributions over all the games.
+	Stats run();
+
+	const std::vector<GameResult>& getResults() const { return results; }
+
+	// Play one game to the end (or the piece limit).
+	// @param seed: Seed of the game's engine.
+	// @param policy: Chooses the placement of every shape.
+	// @param maxPieces: Piece limit.
+	// @return: How the game ended.
+	static GameResult playGame(std::uint64_t seed, PlacementPolicy& policy, int maxPieces);
+
+	// Steer the engine's current shape to a placement with player inputs, then hard drop it
+	// and let the engine process the placed shape. Moves stop early when blocked.
+	// @param engine: The game being played.
+	// @param placement: Where the shape should go.
+	static void applyPlacement(TetrisEngine& engine, const Placement& placement);
+
+private:
+	// Summarize a set of per-game values.
+	static Distribution summarize(std::vector<double> values);
+};
@@ -0,0 +1,49 @@
+#include "SoundEffects.h"
+#include <cassert>
+
+
+// STATIC CONSTANTS ======================================
+
+const char* const SoundEffects::PATHS[static_cast<int>(SoundEffect::COUNT)]{
+	"sounds/blockRotate.ogg",
+	"sounds/blockDrop.ogg",
+	"sounds/levelUp.ogg",
+	"sounds/gameOver.ogg"
+};
+
+const float SoundEffects::VOLUMES[static_cast<int>(SoundEffect::COUNT)]{ 60, 60, 80, 100 };
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+bool SoundEffects::load(const AssetArchive* archive) {
+	for (int effect = 0; effect < static_cast<int>(SoundEffect::COUNT); effect++) {
+		const AssetArchive::Entry* entry = archive ? archive->find(PATHS[effect]) : nullptr;
+		bool loaded = archive ? entry && buffers[effect].loadFromMemory(entry->data, entry->size)
+			: buffers[effect].loadFromFile(PATHS[effect]);
+		if (!loaded) {
+			assert(false && "Missing sound effect");
+			return false;
+		}
+		for (sf::Sound& voice : voices[effect]) {
+			voice.setBuffer(buffers[effect]);
+			voice.setVolume(VOLUMES[effect]);
+		}
+	}
+	return true;
+}
+
+void SoundEffects::play(SoundEffect effect) {
+	int index{ static_cast<int>(effect) };
+	sf::Sound* voice = nullptr;
+	for (sf::Sound& candidate : voices[index]) {
+		if (candidate.getStatus() == sf::Sound::Stopped) {
+			voice = &candidate;
+			break;
+		}
+	}
+	if (!voice) {		// all busy, restart the oldest
+		voice = &voices[index][nextVoice[index]];
+	}
+	nextVoice[index] = (static_cast<int>(voice - voices[index]) + 1) % VOICES_PER_EFFECT;
+	voice->play();
+}
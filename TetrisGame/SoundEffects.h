@@ -0,0 +1,48 @@
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include "AssetArchive.h"
+
+// The short sounds played in response to engine events.
+enum class SoundEffect {
+	Rotate,		// sounds/blockRotate.ogg
+	Drop,		// sounds/blockDrop.ogg
+	LevelUp,	// sounds/levelUp.ogg
+	GameOver,	// sounds/gameOver.ogg
+	COUNT
+};
+
+/*
+ * The SoundEffects class decodes every effect to PCM once when loaded and plays them from a fixed
+ * pool of preallocated voices. Each voice is bound to its effect's buffer at load time (binding a
+ * buffer allocates inside SFML), so play() only restarts a voice: it never allocates or reads a
+ * file, and is safe to call from the game loop. When every voice of an effect is busy, the one
+ * started longest ago is restarted.
+ */
+class SoundEffects {
+public:
+	// Static Constants ============================================================================
+	static const int VOICES_PER_EFFECT{ 3 };	// Overlapping plays of one effect
+	static const char* const PATHS[static_cast<int>(SoundEffect::COUNT)];	// File of each effect
+
+private:
+	static const float VOLUMES[static_cast<int>(SoundEffect::COUNT)];
+
+	sf::SoundBuffer buffers[static_cast<int>(SoundEffect::COUNT)];	// Decoded PCM of each effect
+	sf::Sound voices[static_cast<int>(SoundEffect::COUNT)][VOICES_PER_EFFECT];
+	int nextVoice[static_cast<int>(SoundEffect::COUNT)]{};			// Voice to steal when all are busy
+
+public:
+	SoundEffects() {}
+	SoundEffects(const SoundEffects&) = delete;
+	SoundEffects& operator=(const SoundEffects&) = delete;
+
+	// Decode every effect & bind the voices to them.
+	// @param archive: The archive to load from, or nullptr for loose files.
+	// @return: True if every effect was loaded.
+	bool load(const AssetArchive* archive);
+
+	// Play an effect on one of its voices.
+	// @param effect: The effect.
+	void play(SoundEffect effect);
+};
@@ -0,0 +1,24 @@
+#include "StartupProfile.h"
+#include <iomanip>
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+double StartupProfile::getElapsedMs() const {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void StartupProfile::record(const std::string& name, double startMs, double endMs) {
+	std::lock_guard<std::mutex> lock(mutex);
+	stages.push_back({ name, startMs, endMs });
+}
+
+void StartupProfile::print(std::ostream& out) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	out << "startup (ms):\n" << std::fixed << std::setprecision(1);
+	for (const Stage& stage : stages) {
+		out << "  " << std::setw(24) << std::left << stage.name << std::right
+			<< std::setw(8) << stage.startMs << " .. " << std::setw(8) << stage.endMs
+			<< "  (" << stage.endMs - stage.startMs << ")\n";
+	}
+	out << std::defaultfloat;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ * The StartupProfile class records when each stage of startup (asset loads, window creation,
+ * first frame...) began and ended, relative to the profile's creation. Stages may be recorded
+ * from any thread.
+ */
+class StartupProfile {
+	friend class TestSuite;
+
+public:
+	// Records a stage from its construction to its destruction.
+	class Scope {
+	private:
+		StartupProfile& profile;
+		std::string name;
+		double startMs;
+
+	public:
+		Scope(StartupProfile& profile, const std::string& name)
+			: profile(profile), name(name), startMs(profile.getElapsedMs()) {}
+		~Scope() { profile.record(name, startMs, profile.getElapsedMs()); }
+	};
+
+private:
+	struct Stage {
+		std::string name;
+		double startMs;
+		double endMs;
+	};
+
+	const std::chrono::steady_clock::time_point start;
+	mutable std::mutex mutex;
+	std::vector<Stage> stages;
+
+public:
+	StartupProfile() : start(std::chrono::steady_clock::now()) {}
+
+	// @return: Milliseconds since the profile was created.
+	double getElapsedMs() const;
+
+	// Record a stage.
+	// @param name: What happened.
+	// @param startMs: When it began, from getElapsedMs().
+	// @param endMs: When it ended, from getElapsedMs().
+	void record(const std::string& name, double startMs, double endMs);
+
+	// Record an instant, e.g. the first frame.
+	// @param name: What happened.
+	void mark(const std::string& name) { double now = getElapsedMs(); record(name, now, now); }
+
+	// Print every stage recorded so far, in the order they ended.
+	// @param out: Where to print.
+	void print(std::ostream& out) const;
+};
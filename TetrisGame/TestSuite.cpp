@@ -16,9 +16,100 @@
 #include "GridTetromino.h"
 #endif
 
+#ifdef TETRISENGINE
+#include "TetrisEngine.h"
+#endif
+
+#ifdef RANDOMIZER
+#include "Randomizer.h"
+#include "TetrisEngine.h"
+#endif
+
+#ifdef REPLAY
+#include "Replay.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#endif
+
+#ifdef SELFPLAY
+#include "SelfPlay.h"
+#endif
+
+#ifdef BENCHMARK
+#include "Benchmark.h"
+#endif
+
+#ifdef INPUTHANDLER
+#include "InputHandler.h"
+#include <algorithm>
+#endif
+
+#ifdef TRIPLEBUFFER
+#include "TripleBuffer.h"
+#include "RenderSnapshot.h"
+#include <thread>
+#endif
+
+#ifdef STARTUPPROFILE
+#include "StartupProfile.h"
+#include <sstream>
+#include <thread>
+#endif
+
+#ifdef ASSETARCHIVE
+#include "AssetArchive.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#endif
+
+#ifdef BYTEGRID
+#include "ByteGrid.h"
+#include "Gameboard.h"
+#include "Randomizer.h"
+#include <algorithm>
+#include <vector>
+#endif
+
+#ifdef MOVEGENERATOR
+#include "MoveGenerator.h"
+#include "Randomizer.h"
+#include <algorithm>
+#include <set>
+#include <vector>
+#endif
+
+#ifdef PERFT
+#include "Perft.h"
+#include "Benchmark.h"
+#endif
+
+#ifdef BEAMSEARCH
+#include "BeamSearch.h"
+#include "Benchmark.h"
+#include <atomic>
+#endif
+
+#ifdef ZOBRIST
+#include "BeamSearch.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+#include <thread>
+#endif
+
+#ifdef HEURISTICPOLICY
+#include "BoardFeatures.h"
+#include "SelfPlay.h"
+#include "Randomizer.h"
+#include <cstdlib>
+#endif
+
 #include <cassert>
 #include <iostream>
 #include <string>
+#include <type_traits>
 
 
 
@@ -31,6 +122,21 @@ void TestSuite::runTestSuite()
 	testTetrominoClass();
 	testGameboardClass();
 	testGridTetrominoClass();
+	testTetrisEngineClass();
+	testRandomizerClass();
+	testReplayClass();
+	testSelfPlayRunnerClass();
+	testBenchmarkClass();
+	testTripleBufferClass();
+	testInputHandlerClass();
+	testStartupProfileClass();
+	testAssetArchiveClass();
+	testByteGridClass();
+	testMoveGeneratorClass();
+	testPerftClass();
+	testHeuristicPolicyClass();
+	testBeamSearchPolicyClass();
+	testZobristClass();
 	std::cout << "=== TestSuite complete ========================" << "\n\n";
 }
 
@@ -167,36 +273,47 @@ void TestSuite::testTetrominoClass()
 
 	int blockcount = BLOCK_COUNT;
 
-	assert(t.blockLocs.size() == blockcount &&
+	assert(t.getBlockLocs().size() == blockcount &&
 		"default Tetromino has no blockLocs - likely because no default set in constructor");
 
 	t.setShape(TetShape::S);
-	assert(t.blockLocs.size() == blockcount && "Tetromino shape size should be: 4");
+	assert(t.getBlockLocs().size() == blockcount && "Tetromino shape size should be: 4");
 	t.setShape(TetShape::Z);
-	assert(t.blockLocs.size() == blockcount && "Tetromino shape size should be 4");
+	assert(t.getBlockLocs().size() == blockcount && "Tetromino shape size should be 4");
 	t.setShape(TetShape::L);
-	assert(t.blockLocs.size() == blockcount && "Tetromino shape size should be 4");
+	assert(t.getBlockLocs().size() == blockcount && "Tetromino shape size should be 4");
 	t.setShape(TetShape::J);
-	assert(t.blockLocs.size() == blockcount && "Tetromino shape size should be 4");
+	assert(t.getBlockLocs().size() == blockcount && "Tetromino shape size should be 4");
 	t.setShape(TetShape::O);
-	assert(t.blockLocs.size() == blockcount && "Tetromino shape size should be 4");
+	assert(t.getBlockLocs().size() == blockcount && "Tetromino shape size should be 4");
 	t.setShape(TetShape::I);
-	assert(t.blockLocs.size() == blockcount && "Tetromino shape size should be 4");
+	assert(t.getBlockLocs().size() == blockcount && "Tetromino shape size should be 4");
 	t.setShape(TetShape::T);
-	assert(t.blockLocs.size() == blockcount && "Tetromino shape size should be 4");
-
+	assert(t.getBlockLocs().size() == blockcount && "Tetromino shape size should be 4");
+
+
+	// test the rotate functionality: every orientation in the table must be the previous
+	// orientation rotated clockwise ([x,y] -> [y,-x]), and 4 rotations return to the start.
+	for (int shape = 0; shape < static_cast<int>(TetShape::COUNT); shape++) {
+		t.setShape(static_cast<TetShape>(shape));
+		assert(t.getOrientation() == 0 && "Tetromino::setShape() should reset the orientation");
+		for (int r = 0; r < Tetromino::ORIENTATION_COUNT; r++) {
+			Tetromino::BlockLocs before = t.getBlockLocs();
+			t.rotateClockwise();
+			assert(t.getOrientation() == (r + 1) % Tetromino::ORIENTATION_COUNT && "Tetromino::rotateClockwise() failed");
+			for (int i = 0; i < BLOCK_COUNT; i++) {
+				Point expected = before[i];
+				expected.swapXY();
+				expected.multiplyY(-1);
+				assert(t.getBlockLocs()[i] == expected && "Tetromino::rotateClockwise() failed");
+			}
+		}
+		assert(t.getOrientation() == 0 && "Tetromino::rotateClockwise() 4 rotations should return to the start");
+	}
 
-	// test the rotate functionality of a single block
-	t.blockLocs.clear();
-	t.blockLocs.push_back(Point(1, 2));
-	t.rotateClockwise();
-	assert(t.blockLocs[0].getX() == 2 && t.blockLocs[0].getY() == -1 && "Tetromino::rotateClockwise() failed");
-	t.rotateClockwise();
-	assert(t.blockLocs[0].getX() == -1 && t.blockLocs[0].getY() == -2 && "Tetromino::rotateClockwise() failed");
-	t.rotateClockwise();
-	assert(t.blockLocs[0].getX() == -2 && t.blockLocs[0].getY() == 1 && "Tetromino::rotateClockwise() failed");
-	t.rotateClockwise();
-	assert(t.blockLocs[0].getX() == 1 && t.blockLocs[0].getY() == 2 && "Tetromino::rotateClockwise() failed");
+	// a Tetromino should be a small, trivially copyable value
+	assert(std::is_trivially_copyable<Tetromino>::value && "Tetromino should be trivially copyable");
+	assert(sizeof(Tetromino) <= 4 && "Tetromino should only hold color, shape & orientation");
 
 	// ensure const methods are actually const
 	// These lines will cause compile time errors you have methods in your Tetromino class that
@@ -339,6 +456,21 @@ void TestSuite::testGameboardClass()
 	assert(completedRows.size() == 2 && completedRows[0] == 2 && completedRows[1] == 4 &&
 		"Gameboard.getCompletedRowIndices() does not return expected results");
 
+	// test getCompletedRows() & getRowFillCount() are maintained as blocks change
+	g.empty();
+	assert(g.getCompletedRows().none() && "Gameboard.getCompletedRows() should be empty");
+	for (int x = 0; x < Gameboard::MAX_X; x++) {
+		assert(g.getRowFillCount(6) == x && "Gameboard.getRowFillCount() unexpected count");
+		g.setContent(x, 6, 1);
+	}
+	assert(g.getRowFillCount(6) == Gameboard::MAX_X && "Gameboard.getRowFillCount() unexpected count");
+	assert(g.getCompletedRows().count() == 1 && g.getCompletedRows()[6] && "Gameboard.getCompletedRows() should contain row 6");
+	g.setContent(3, 6, Gameboard::EMPTY_BLOCK);
+	assert(g.getCompletedRows().none() && "Gameboard.getCompletedRows() clearing a block should make row incomplete");
+	g.copyRowIntoRow(6, 7);
+	g.setContent(3, 7, 2);
+	assert(g.getCompletedRows()[7] && !g.getCompletedRows()[6] && "Gameboard.getCompletedRows() unexpected results");
+
 	// test removeCompletedRows()
 	g.empty();
 	assert(g.removeCompletedRows() == 0 && "Gameboard.removeCompletedRows() should return 0");
@@ -365,6 +497,20 @@ void TestSuite::testGameboardClass()
 	assert(g.getContent(1, 4) == Gameboard::EMPTY_BLOCK && "Gameboard.removeCompletedRows() unexpected results");	// row 4 is still empty
 
 
+	// test removeCompletedRows() with interleaved completed and partial rows (single sweep)
+	g.empty();
+	for (int y = Gameboard::MAX_Y - 5; y < Gameboard::MAX_Y; y++) {
+		g.fillRow(y, y);
+	}
+	g.setContent(0, Gameboard::MAX_Y - 4, Gameboard::EMPTY_BLOCK);	// partial
+	g.setContent(1, Gameboard::MAX_Y - 2, Gameboard::EMPTY_BLOCK);	// partial
+	assert(g.removeCompletedRows() == 3 && "Gameboard.removeCompletedRows() should return 3");
+	assert(g.getContent(2, Gameboard::MAX_Y - 1) == Gameboard::MAX_Y - 2 && "Gameboard.removeCompletedRows() unexpected results");
+	assert(g.getContent(1, Gameboard::MAX_Y - 1) == Gameboard::EMPTY_BLOCK && "Gameboard.removeCompletedRows() unexpected results");
+	assert(g.getContent(2, Gameboard::MAX_Y - 2) == Gameboard::MAX_Y - 4 && "Gameboard.removeCompletedRows() unexpected results");
+	assert(g.getContent(0, Gameboard::MAX_Y - 2) == Gameboard::EMPTY_BLOCK && "Gameboard.removeCompletedRows() unexpected results");
+	assert(g.getRowMask(Gameboard::MAX_Y - 3) == 0 && "Gameboard.removeCompletedRows() top rows should be empty");
+
 	// test areLocsEmpty()
 	g.empty();
 	g.fillRow(2, 2);
@@ -390,6 +536,62 @@ void TestSuite::testGameboardClass()
 	std::vector<Point> mixedPoints2 = { Point(-3,-20), Point(200, 23), Point(6, 6), Point(3,3) };
 	assert(g.areAllLocsEmpty(mixedPoints2) == false && "Gameboard.areAllLocsEmpty() expected false but was true");
 
+	// test getRowMask() & isRowMaskClear()
+	g.empty();
+	assert(g.getRowMask(5) == 0 && "Gameboard.getRowMask() expected an empty row");
+	g.setContent(0, 5, 1);
+	g.setContent(3, 5, 2);
+	assert(g.getRowMask(5) == ((1 << 0) | (1 << 3)) && "Gameboard.getRowMask() unexpected mask");
+	g.setContent(0, 5, Gameboard::EMPTY_BLOCK);
+	assert(g.getRowMask(5) == (1 << 3) && "Gameboard.getRowMask() clearing a block should clear its bit");
+	assert(g.isRowMaskClear(5, 1 << 2) == true && "Gameboard.isRowMaskClear() expected true but was false");
+	assert(g.isRowMaskClear(5, (1 << 2) | (1 << 3)) == false && "Gameboard.isRowMaskClear() expected false but was true");
+	assert(g.isRowMaskClear(-1, Gameboard::FULL_ROW_MASK) == true && "Gameboard.isRowMaskClear() rows above the board should be clear");
+	assert(g.isRowMaskClear(Gameboard::MAX_Y, 1) == false && "Gameboard.isRowMaskClear() rows below the board should be full");
+
+	// row masks must follow the color plane through row copies and removals
+	g.empty();
+	for (int x = 0; x < Gameboard::MAX_X; x++) {
+		g.setContent(x, Gameboard::MAX_Y - 1, 1);
+	}
+	g.setContent(4, Gameboard::MAX_Y - 2, 3);
+	assert(g.isRowCompleted(Gameboard::MAX_Y - 1) == true);
+	assert(g.removeCompletedRows() == 1);
+	assert(g.getRowMask(Gameboard::MAX_Y - 1) == (1 << 4) && "Gameboard.removeCompletedRows() row mask was not shifted down");
+	assert(g.getRowMask(Gameboard::MAX_Y - 2) == 0 && "Gameboard.removeCompletedRows() row mask was not shifted down");
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			bool filled = (g.getRowMask(y) >> x) & 1;
+			assert(filled == (g.getContent(x, y) != Gameboard::EMPTY_BLOCK) && "Gameboard row mask out of sync with grid");
+		}
+	}
+
+	// test getColumnHeight() follows sets, clears & row removal
+	g.empty();
+	assert(g.getColumnHeight(0) == 0 && "Gameboard.getColumnHeight() empty column should be 0");
+	g.setContent(0, Gameboard::MAX_Y - 1, 1);
+	g.setContent(0, Gameboard::MAX_Y - 4, 1);
+	assert(g.getColumnHeight(0) == 4 && "Gameboard.getColumnHeight() unexpected height");
+	g.setContent(0, Gameboard::MAX_Y - 4, Gameboard::EMPTY_BLOCK);
+	assert(g.getColumnHeight(0) == 1 && "Gameboard.getColumnHeight() clearing the top block should lower the column");
+	g.fillRow(Gameboard::MAX_Y - 2, 2);
+	assert(g.getColumnHeight(5) == 2 && "Gameboard.getColumnHeight() unexpected height after fillRow()");
+	g.setContent(5, Gameboard::MAX_Y - 6, 3);
+	g.removeCompletedRows();
+	assert(g.getColumnHeight(0) == 1 && g.getColumnHeight(1) == 0 && g.getColumnHeight(5) == 5 &&
+		"Gameboard.getColumnHeight() unexpected height after removeCompletedRows()");
+
+	// test getDropDistance() above the skyline and tucked under an overhang
+	g.empty();
+	g.setContent(3, Gameboard::MAX_Y - 1, 1);
+	Point dropLocs[] = { Point(2, 0), Point(3, 0), Point(4, 0), Point(3, 1) };
+	assert(g.getDropDistance(dropLocs, 4) == Gameboard::MAX_Y - 3 && "Gameboard.getDropDistance() unexpected distance");
+	g.setContent(2, 5, 1);	// overhang over column 2, block below it
+	Point tuckLocs[] = { Point(2, 7), Point(2, 8) };
+	assert(g.getDropDistance(tuckLocs, 2) == Gameboard::MAX_Y - 9 && "Gameboard.getDropDistance() unexpected distance under an overhang");
+	Point floorLocs[] = { Point(0, Gameboard::MAX_Y - 1) };
+	assert(g.getDropDistance(floorLocs, 1) == 0 && "Gameboard.getDropDistance() blocks on the floor can't drop");
+
 	// lastly do a visual printout of an empty board
 	g.empty();
 	g.printToConsole();
@@ -420,6 +622,11 @@ void TestSuite::testGameboardClass()
 	g2.getCompletedRowIndices();
 	g2.isValidPoint(1, 1);
 	g2.isValidPoint(Point(3, 3));
+	g2.getRowMask(0);
+	g2.isRowMaskClear(0, 1);
+	g2.getCompletedRows();
+	g2.getRowFillCount(0);
+	g2.getColumnHeight(0);
 
 
 	// These methods should ignore invalid points
@@ -433,6 +640,20 @@ void TestSuite::testGameboardClass()
 	std::vector<Point> invalidPoints2{ Point(-5,-5), Point(50,50) };
 	g3.setContent(invalidPoints2, 1);
 
+	// board dimensions are template parameters: rows use the narrowest mask that fits
+	static_assert(sizeof(Gameboard::RowMask) == 2 && sizeof(BasicGameboard<16, 4>::RowMask) == 2, "16 bit rows up to 16 wide");
+	static_assert(sizeof(BasicGameboard<32, 64>::RowMask) == 4 && sizeof(BasicGameboard<40, 100>::RowMask) == 8, "32/64 bit rows for wider boards");
+	static_assert(BasicGameboard<32, 64>::FULL_ROW_MASK == 0xFFFFFFFFu && BasicGameboard<40, 100>::FULL_ROW_MASK == 0xFFFFFFFFFFull, "FULL_ROW_MASK of wide boards");
+	BasicGameboard<40, 100> wide;
+	for (int x = 0; x < 40; x++) {
+		wide.setContent(x, 99, 0);
+	}
+	wide.setContent(39, 98, 0);
+	assert(wide.getCompletedRows()[99] && wide.getColumnHeight(39) == 2 && "BasicGameboard<40, 100> row tracking failed");
+	assert(wide.removeCompletedRows() == 1 && wide.getContent(39, 99) == 0 && wide.getRowFillCount(99) == 1 && "BasicGameboard<40, 100> row removal failed");
+	Point wideShape[] = { Point(36, 99), Point(37, 99), Point(38, 99) };
+	assert(wide.getShiftDistance(wideShape, 3, 1) == 0 && wide.getShiftDistance(wideShape, 3, -1) == 36 && "BasicGameboard<40, 100> shift failed");
+
 
 	announceTestCompletion();
 #else
@@ -467,10 +688,19 @@ void TestSuite::testGridTetrominoClass()
 
 
 	// test getBlockLocsMappedToGrid()
-	gt.blockLocs = { Point(1,2) };
+	gt.setShape(TetShape::L);
+	gt.rotateClockwise();
 	gt.setGridLoc(5, 5);
-	std::vector<Point> locs = gt.getBlockLocsMappedToGrid();
-	assert(locs[0].getX() == 6 && locs[0].getY() == 7);
+	GridTetromino::BlockLocs locs = gt.getBlockLocsMappedToGrid();
+	for (int i = 0; i < BLOCK_COUNT; i++) {
+		assert(locs[i].getX() == gt.getBlockLocs()[i].getX() + 5 && locs[i].getY() == gt.getBlockLocs()[i].getY() + 5);
+	}
+
+	// moving or rotating a copy must not affect the original
+	GridTetromino copy = gt;
+	copy.move(1, 1);
+	copy.rotateClockwise();
+	assert(gt.getGridLoc().getX() == 5 && gt.getOrientation() == 1);
 
 	// A const gridTetromino should be able to call the following methods
 	// (since these methods don't change the state of the class)
@@ -491,4 +721,1253 @@ void TestSuite::testGridTetrominoClass()
 
 
 
+void TestSuite::testTetrisEngineClass()
+{
+#ifdef TETRISENGINE
+	announceTest("TetrisEngine");
+
+	TetrisEngine engine;
+
+	// a new engine has reset itself and raised a GameReset event
+	assert(engine.getGameLoopState() == GameLoopState::Playing && "TetrisEngine ctor should start Playing");
+	assert(engine.getScore() == 0 && "TetrisEngine ctor should start with a score of 0");
+	assert(engine.getCurrentShape().getGridLoc() == engine.getBoard().getSpawnLoc() && "TetrisEngine ctor should spawn a shape");
+	assert(hasEvent(engine.takeEvents(), GameEvent::GameReset) && "TetrisEngine ctor should raise GameReset");
+	assert(engine.takeEvents() == 0 && "TetrisEngine.takeEvents() should clear the events");
+
+	// inputs move the current shape
+	Point spawn = engine.getCurrentShape().getGridLoc();
+	engine.handleInput(GameInput::MoveLeft);
+	assert(engine.getCurrentShape().getGridLoc().getX() == spawn.getX() - 1 && "TetrisEngine MoveLeft failed");
+	engine.handleInput(GameInput::MoveRight);
+	engine.handleInput(GameInput::SoftDrop);
+	assert(engine.getCurrentShape().getGridLoc() == Point(spawn.getX(), spawn.getY() + 1) && "TetrisEngine MoveRight/SoftDrop failed");
+
+	// the ghost shape sits where a hard drop will land
+	GridTetromino ghost = engine.getGhostShape();
+	TetColor color = engine.getCurrentShape().getColor();
+	GridTetromino::BlockLocs landing = ghost.getBlockLocsMappedToGrid();
+	engine.handleInput(GameInput::HardDrop);
+	assert(hasEvent(engine.takeEvents(), GameEvent::ShapeLocked) && "TetrisEngine HardDrop should lock the shape");
+	for (const Point& p : landing) {
+		assert(engine.getBoard().getContent(p) == static_cast<int>(color) && "TetrisEngine HardDrop landed away from the ghost");
+	}
+
+	// the locked shape ignores inputs until the next step spawns a new one
+	Gameboard locked = engine.getBoard();
+	engine.handleInput(GameInput::MoveLeft);
+	assert(engine.shiftToWall(GameInput::MoveLeft) == 0 && "TetrisEngine.shiftToWall() should be ignored after a HardDrop");
+	engine.handleInput(GameInput::HardDrop);
+	assert(!hasEvent(engine.takeEvents(), GameEvent::ShapeLocked) && "TetrisEngine should not lock a shape twice");
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		assert(engine.getBoard().getRowMask(y) == locked.getRowMask(y) && "A second HardDrop in the same step should be a no-op");
+	}
+
+	// the next step spawns the shape that was on deck
+	TetShape onDeck = engine.getNextShape().getShape();
+	engine.step(0.0);
+	assert(engine.getCurrentShape().getShape() == onDeck && "TetrisEngine.step() should spawn the next shape");
+	assert(engine.getCurrentShape().getGridLoc() == engine.getBoard().getSpawnLoc() && "TetrisEngine.step() should spawn at the spawn location");
+
+	// gravity: a step longer than the tick rate moves the shape down by one
+	spawn = engine.getCurrentShape().getGridLoc();
+	engine.step(engine.getSecondsPerTick() / 2);
+	assert(engine.getCurrentShape().getGridLoc() == spawn && "TetrisEngine.step() ticked too early");
+	engine.step(engine.getSecondsPerTick());
+	assert(engine.getCurrentShape().getGridLoc().getY() == spawn.getY() + 1 && "TetrisEngine.step() should tick");
+
+	// a long step runs every tick that fell due, processing placements in between
+	engine.reset();
+	spawn = engine.getCurrentShape().getGridLoc();
+	engine.step(engine.getSecondsPerTick() * 3.5);
+	assert(engine.getCurrentShape().getGridLoc().getY() == spawn.getY() + 3 && "TetrisEngine.step() should catch up on missed ticks");
+	assert(engine.getTickProgress() > 0.45 && engine.getTickProgress() < 0.55 && "TetrisEngine.getTickProgress() failed");
+	engine.step(engine.getSecondsPerTick() * (Gameboard::MAX_Y + 2));
+	assert(engine.getPiecesPlaced() == 1 && engine.getCurrentShape().getGridLoc().getY() > spawn.getY() &&
+		"TetrisEngine.step() should lock, spawn & keep ticking within one step");
+
+	// completing a row scores & removes it
+	engine.reset();
+	engine.takeEvents();
+	for (int x = 0; x < Gameboard::MAX_X; x++) {
+		engine.board.setContent(x, Gameboard::MAX_Y - 1, 0);
+	}
+	engine.board.setContent(0, Gameboard::MAX_Y - 2, 0);
+	engine.handleInput(GameInput::HardDrop);
+	engine.step(0.0);
+	assert(engine.getScore() == 100 && "TetrisEngine should score 100 for a single row");
+	assert(hasEvent(engine.takeEvents(), GameEvent::RowsCleared) && "TetrisEngine should raise RowsCleared");
+	assert(engine.getBoard().getContent(0, Gameboard::MAX_Y - 1) == 0 && "TetrisEngine should shift rows down after clearing");
+
+	// a faster tick rate raises LevelUp, a slower one (after a reset) doesn't
+	engine.score = 500;
+	engine.determineSecondsPerTick();
+	assert(hasEvent(engine.takeEvents(), GameEvent::LevelUp) && "TetrisEngine should raise LevelUp");
+	engine.determineSecondsPerTick();
+	assert(!hasEvent(engine.takeEvents(), GameEvent::LevelUp) && "TetrisEngine LevelUp should only be raised once per level");
+	engine.score = 100;
+	engine.determineSecondsPerTick();
+	assert(!hasEvent(engine.takeEvents(), GameEvent::LevelUp) && "TetrisEngine should not raise LevelUp when slowing down");
+
+	// a blocked spawn ends the game, and the game resets after GAME_OVER_RESET_SECONDS
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		engine.board.setContent(engine.getBoard().getSpawnLoc().getX(), y, 0);
+	}
+	engine.handleInput(GameInput::HardDrop);
+	engine.step(0.0);
+	assert(engine.getGameLoopState() == GameLoopState::GameOver && "TetrisEngine should end the game when the spawn is blocked");
+	assert(hasEvent(engine.takeEvents(), GameEvent::GameOver) && "TetrisEngine should raise GameOver");
+	engine.handleInput(GameInput::MoveLeft);	// ignored while game over
+	engine.step(TetrisEngine::GAME_OVER_RESET_SECONDS);
+	assert(engine.getGameLoopState() == GameLoopState::Playing && engine.getScore() == 0 && "TetrisEngine should reset after a game over");
+	assert(hasEvent(engine.takeEvents(), GameEvent::GameReset) && "TetrisEngine should raise GameReset");
+
+	// the engine is a plain value: copies play on independently
+	TetrisEngine copy = engine;
+	copy.handleInput(GameInput::HardDrop);
+	assert(engine.getBoard().getRowMask(Gameboard::MAX_Y - 1) == 0 && "TetrisEngine copies should be independent");
+
+	// a wide board variant plays the same rules: hard drops from the middle until the stack tops out
+	BasicTetrisEngine<40, 100> wide(3);
+	assert(wide.getBoard().getSpawnLoc().getX() == 20 && "BasicTetrisEngine<40, 100> should spawn in the middle");
+	while (wide.getGameLoopState() == GameLoopState::Playing) {
+		wide.handleInput(GameInput::HardDrop);
+		wide.step(0.0);
+	}
+	assert(wide.getPiecesPlaced() > 25 && wide.getBoard().getColumnHeight(20) > 95 && "BasicTetrisEngine<40, 100> should stack up to the top");
+
+	announceTestCompletion();
+#else
+	announceNotTested("TetrisEngine");
+#endif
+}
+
+
+
+void TestSuite::testRandomizerClass()
+{
+#ifdef RANDOMIZER
+	announceTest("Randomizer");
+
+	// Pcg32 must match the reference PCG32 output (pcg32_srandom(42, 54)) on every platform
+	Pcg32 rng(42, 54);
+	assert(rng.next() == 0xa15c02b7u && "Pcg32.next() does not match the reference sequence");
+	assert(rng.next() == 0x7b47f409u && "Pcg32.next() does not match the reference sequence");
+	assert(rng.next() == 0xba1d3330u && "Pcg32.next() does not match the reference sequence");
+	for (int i = 0; i < 1000; i++) {
+		assert(rng.nextBelow(7) < 7 && "Pcg32.nextBelow() out of range");
+	}
+
+	// every bag deals each shape exactly once
+	Randomizer r(1234);
+	for (int bag = 0; bag < 20; bag++) {
+		int counts[Randomizer::BAG_SIZE] = {};
+		for (int i = 0; i < Randomizer::BAG_SIZE; i++) {
+			counts[static_cast<int>(r.nextShape())]++;
+		}
+		for (int count : counts) {
+			assert(count == 1 && "Randomizer bag should contain every shape once");
+		}
+	}
+
+	// equal seeds deal equal games, previewing doesn't change what is dealt
+	Randomizer a(99), b(99), c(100);
+	bool differs = false;
+	for (int i = 0; i < 200; i++) {
+		TetShape peeked = a.peekShape(Randomizer::PREVIEW_CAPACITY - 1);
+		(void)peeked;
+		TetShape expected = b.peekShape(0);
+		assert(a.peekShape(0) == expected && "Randomizer.peekShape() should agree for equal seeds");
+		assert(a.nextShape() == b.nextShape() && "Randomizer.nextShape() should agree for equal seeds");
+		assert(a.nextColor() == b.nextColor() && "Randomizer.nextColor() should agree for equal seeds");
+		differs = differs || (c.nextShape() != expected);
+	}
+	assert(differs && "Randomizer with different seeds should deal different games");
+
+	// reseeding restarts the sequence
+	Randomizer d(7);
+	TetShape first = d.nextShape();
+	d.nextShape();
+	d.reseed(7);
+	assert(d.nextShape() == first && d.getSeed() == 7 && "Randomizer.reseed() should restart the sequence");
+
+	// engines with the same seed deal the same pieces
+	TetrisEngine e1(5), e2(5);
+	for (int i = 0; i < 50; i++) {
+		assert(e1.getCurrentShape().getShape() == e2.getCurrentShape().getShape() &&
+			e1.getNextShape().getColor() == e2.getNextShape().getColor() && "TetrisEngine with equal seeds should deal equal pieces");
+		e1.handleInput(GameInput::HardDrop);
+		e2.handleInput(GameInput::HardDrop);
+		e1.step(0.0);
+		e2.step(0.0);
+	}
+
+	announceTestCompletion();
+#else
+	announceNotTested("Randomizer");
+#endif
+}
+
+
+
+#ifdef REPLAY
+bool areEnginesEqual(const TetrisEngine& a, const TetrisEngine& b)
+{
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			if (a.getBoard().getContent(x, y) != b.getBoard().getContent(x, y)) { return false; }
+		}
+	}
+	return a.getScore() == b.getScore() &&
+		a.getGameLoopState() == b.getGameLoopState() &&
+		a.getCurrentShape() == b.getCurrentShape() &&
+		a.getCurrentShape().getOrientation() == b.getCurrentShape().getOrientation() &&
+		a.getNextShape().getShape() == b.getNextShape().getShape() &&
+		a.getPiecesPlaced() == b.getPiecesPlaced();
+}
+#endif
+
+
+void TestSuite::testReplayClass()
+{
+#ifdef REPLAY
+	announceTest("Replay");
+
+	// record a long session of random inputs & uneven frame times, spanning several game overs
+	const std::uint64_t seed = 2024;
+	TetrisEngine engine(seed);
+	Replay replay(seed);
+	engine.setRecorder(&replay);
+	Pcg32 script(7, 0);
+	int gameOvers = 0;
+	for (int frame = 0; frame < 60000; frame++) {
+		std::uint32_t roll = script.nextBelow(100);
+		if (roll < 25) {
+			engine.handleInput(static_cast<GameInput>(script.nextBelow(4)));	// rotate, left, right, soft drop
+		}
+		else if (roll < 27) {
+			engine.handleInput(GameInput::HardDrop);
+		}
+		engine.step((10 + script.nextBelow(40)) / 1000.0);
+		if (hasEvent(engine.takeEvents(), GameEvent::GameOver)) {
+			gameOvers++;
+		}
+	}
+	assert(gameOvers > 0 && "Replay test should span a game over");
+
+	// playback at full speed reproduces the game exactly
+	ReplayPlayer player(replay);
+	player.playToEnd();
+	assert(player.isAtEnd() && player.getEventIndex() == replay.getEventCount() && "ReplayPlayer should play every event");
+	assert(areEnginesEqual(player.getEngine(), engine) && "ReplayPlayer should reproduce the recorded game");
+	assert(replay.getByteCount() < 3 * replay.getEventCount() && "Replay should cost a couple of bytes per event");
+
+	// seeking backward and forward lands on the same state as playing from the start
+	std::uint32_t target = player.getPlacementCount() / 2 + 3;
+	player.seekToPlacement(target);
+	ReplayPlayer fromStart(replay);
+	while (fromStart.getPlacementCount() < target && fromStart.step());
+	assert(player.getPlacementCount() == target && areEnginesEqual(player.getEngine(), fromStart.getEngine()) &&
+		"ReplayPlayer.seekToPlacement() should match playing from the start");
+	player.seekToPlacement(target + 100);
+	while (fromStart.getPlacementCount() < target + 100 && fromStart.step());
+	assert(areEnginesEqual(player.getEngine(), fromStart.getEngine()) && "ReplayPlayer.seekToPlacement() forward failed");
+
+	// save & load round trip
+	const char* path = "replay_test.tmp";
+	assert(replay.saveToFile(path) && "Replay.saveToFile() failed");
+	Replay loaded;
+	assert(loaded.loadFromFile(path) && "Replay.loadFromFile() failed");
+	std::remove(path);
+	assert(loaded.getSeed() == seed && loaded.getEventCount() == replay.getEventCount() && "Replay.loadFromFile() header mismatch");
+	ReplayPlayer loadedPlayer(loaded);
+	loadedPlayer.playToEnd();
+	assert(areEnginesEqual(loadedPlayer.getEngine(), engine) && "Loaded replay should reproduce the recorded game");
+	assert(loaded.loadFromFile("missing_replay.tmp") == false && "Replay.loadFromFile() should fail on a missing file");
+
+	// a file shorter than its header claims is rejected before anything is allocated
+	assert(replay.saveToFile(path) && "Replay.saveToFile() failed");
+	std::string saved;
+	{
+		std::ifstream in(path, std::ios::binary);
+		saved.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+	std::ofstream(path, std::ios::binary) << saved.substr(0, saved.size() - 1);
+	assert(!loaded.loadFromFile(path) && "Replay.loadFromFile() should fail on a truncated file");
+	std::string header{ saved.substr(0, saved.size() - replay.getByteCount()) };
+	header.replace(header.size() - 4, 4, 4, '\xFF');		// claim 4 GiB of events
+	std::ofstream(path, std::ios::binary) << header << saved.substr(header.size());
+	assert(!loaded.loadFromFile(path) && "Replay.loadFromFile() should fail when the size is out of range");
+	std::remove(path);
+
+	// over-long & cut off varints stop playback instead of decoding garbage
+	for (std::size_t length : { 11, 1 }) {
+		Replay corrupt(seed);
+		corrupt.bytes.assign(length, 0x80);
+		ReplayPlayer corruptPlayer(corrupt);
+		assert(!corruptPlayer.step() && corruptPlayer.isMalformed() && corruptPlayer.getEventIndex() == 0 && "ReplayPlayer should reject a malformed varint");
+	}
+	assert(!loadedPlayer.isMalformed() && "ReplayPlayer should decode a well formed replay");
+
+	announceTestCompletion();
+#else
+	announceNotTested("Replay");
+#endif
+}
+
+
+
+#ifdef SELFPLAY
+// Drops every shape at a fixed placement, checking the board between placements.
+class CheckedPolicy : public PlacementPolicy {
+public:
+	Placement placement;
+	int calls{ 0 };
+
+	Placement choosePlacement(const TetrisEngine& engine) override {
+		const Gameboard& board = engine.getBoard();
+		assert(board.getCompletedRows().none() && "Completed rows should be removed before the next placement");
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			int height{ 0 };
+			for (int y = 0; y < Gameboard::MAX_Y; y++) {
+				if (board.getContent(x, y) != Gameboard::EMPTY_BLOCK) { height = Gameboard::MAX_Y - y; break; }
+			}
+			assert(board.getColumnHeight(x) == height && "Column skyline out of sync during self play");
+		}
+		calls++;
+		return placement;
+	}
+};
+#endif
+
+
+void TestSuite::testSelfPlayRunnerClass()
+{
+#ifdef SELFPLAY
+	announceTest("SelfPlayRunner");
+
+	// applyPlacement() steers the shape before dropping it
+	TetrisEngine engine(11);
+	Placement target;
+	target.orientation = 1;
+	target.x = 0;
+	SelfPlayRunner::applyPlacement(engine, target);
+	assert(engine.getPiecesPlaced() == 1 && "SelfPlayRunner.applyPlacement() should place exactly one shape");
+	bool touchesLeftWall{ false };
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		touchesLeftWall = touchesLeftWall || engine.getBoard().getContent(0, y) != Gameboard::EMPTY_BLOCK;
+	}
+	assert(touchesLeftWall && "SelfPlayRunner.applyPlacement() should move the shape against the left wall");
+
+	// a game always ends with a top out or at the piece limit
+	CheckedPolicy stacker;
+	stacker.placement.x = Gameboard::MAX_X / 2;
+	GameResult stacked = SelfPlayRunner::playGame(5, stacker, 1000);
+	assert(stacked.toppedOut && stacked.piecesPlaced == stacker.calls && stacked.piecesPlaced < Gameboard::MAX_Y && "Stacking in one column should top out");
+	RandomPolicy random(5);
+	GameResult limited = SelfPlayRunner::playGame(5, random, 3);
+	assert(!limited.toppedOut && limited.piecesPlaced == 3 && "SelfPlayRunner.playGame() should stop at maxPieces");
+
+	// results are the same whatever the thread count
+	SelfPlayRunner::Config config;
+	config.games = 40;
+	config.baseSeed = 100;
+	config.threads = 1;
+	PolicyFactory makeRandom = [](std::uint64_t seed) { return std::unique_ptr<PlacementPolicy>(new RandomPolicy(seed)); };
+	SelfPlayRunner serial(config, makeRandom);
+	SelfPlayRunner::Stats serialStats = serial.run();
+	config.threads = 4;
+	SelfPlayRunner parallel(config, makeRandom);
+	SelfPlayRunner::Stats parallelStats = parallel.run();
+	assert(parallelStats.threads == 4 && parallel.getResults().size() == 40 && "SelfPlayRunner should play every game");
+	long long pieces{ 0 };
+	for (int i = 0; i < config.games; i++) {
+		const GameResult& a = serial.getResults()[i];
+		const GameResult& b = parallel.getResults()[i];
+		assert(a.seed == static_cast<std::uint64_t>(100 + i) && a.seed == b.seed && a.score == b.score && a.piecesPlaced == b.piecesPlaced &&
+			a.linesCleared == b.linesCleared && "SelfPlayRunner results should not depend on the thread count");
+		pieces += b.piecesPlaced;
+	}
+	assert(parallelStats.totalPieces == pieces && serialStats.totalPieces == pieces && "SelfPlayRunner.run() totals are wrong");
+	assert(parallelStats.gameLength.min <= parallelStats.gameLength.p50 && parallelStats.gameLength.p50 <= parallelStats.gameLength.p90 &&
+		parallelStats.gameLength.p99 <= parallelStats.gameLength.max && "SelfPlayRunner distributions should be ordered");
+	assert(parallelStats.gameLength.mean * config.games == pieces && "SelfPlayRunner mean game length is wrong");
+
+	announceTestCompletion();
+#else
+	announceNotTested("SelfPlayRunner");
+#endif
+}
+
+
+void TestSuite::testBenchmarkClass()
+{
+#ifdef BENCHMARK
+	announceTest("Benchmark");
+
+	// fixtures are deterministic & have the advertised heights, without completed rows
+	const int expectedRows[] = { 0, Gameboard::MAX_Y / 2, 15 };
+	for (int f = 0; f < static_cast<int>(Benchmark::BoardFill::COUNT); f++) {
+		Benchmark::BoardFill fill{ static_cast<Benchmark::BoardFill>(f) };
+		Gameboard board = Benchmark::makeBoard(fill);
+		Gameboard again = Benchmark::makeBoard(fill);
+		int rows{ 0 };
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			assert(board.getRowMask(y) == again.getRowMask(y) && "Benchmark.makeBoard() should be deterministic");
+			rows += board.getRowMask(y) != 0;
+		}
+		assert(rows == expectedRows[f] && board.getCompletedRows().none() && "Benchmark.makeBoard() has the wrong fill");
+	}
+
+	// every operation is measured on every fill, and allocations are counted in bench builds
+	std::vector<Benchmark::Result> results = Benchmark(0.0).runAll();
+	assert(results.size() % static_cast<int>(Benchmark::BoardFill::COUNT) == 0 && "Benchmark.runAll() should cover every fill");
+	for (const Benchmark::Result& r : results) {
+		assert(r.iterations > 0 && r.nsPerOp >= 0 && "Benchmark.measure() should time some iterations");
+		if (!Benchmark::COUNTS_ALLOCATIONS) {
+			assert(r.allocsPerOp == 0 && "Benchmark should not count allocations without TETRIS_BENCH");
+			continue;
+		}
+		if (r.name.find("getCompletedRowIndices") != std::string::npos) {
+			assert(r.allocsPerOp >= 1 && "Benchmark should count the vector allocated by getCompletedRowIndices()");
+		}
+		if (r.name.find("attemptMove") != std::string::npos) {
+			assert(r.allocsPerOp == 0 && "TetrisEngine.attemptMove() should not allocate");
+		}
+	}
+	std::size_t before{ Benchmark::getAllocationCount() };
+	std::vector<int>* allocated = new std::vector<int>(8);
+	delete allocated;
+	assert(Benchmark::getAllocationCount() - before == (Benchmark::COUNTS_ALLOCATIONS ? 2 : 0) && "Benchmark.getAllocationCount() should count operator new calls");
+
+	announceTestCompletion();
+#else
+	announceNotTested("Benchmark");
+#endif
+}
+
+
+void TestSuite::testTripleBufferClass()
+{
+#ifdef TRIPLEBUFFER
+	announceTest("TripleBuffer");
+
+	// the reader sees the newest published value, and keeps it until the next publish
+	TripleBuffer<int> buffer;
+	buffer.beginWrite() = 0;
+	buffer.publish();
+	assert(buffer.update() && buffer.read() == 0 && "TripleBuffer.update() should take a published value");
+	assert(!buffer.update() && buffer.read() == 0 && "TripleBuffer.update() without a publish should keep the value");
+	for (int i = 1; i <= 5; i++) {
+		buffer.beginWrite() = i;
+		buffer.publish();
+	}
+	assert(buffer.update() && buffer.read() == 5 && "TripleBuffer.update() should skip to the newest value");
+	buffer.beginWrite() = 6;
+	assert(!buffer.update() && buffer.read() == 5 && "TripleBuffer should not expose an unpublished value");
+
+	// a reader thread never sees a torn or older snapshot while the writer keeps publishing
+	TripleBuffer<RenderSnapshot> snapshots;
+	TetrisEngine engine(3);
+	const int PUBLISHES = 20000;
+	std::thread writer([&]() {
+		for (std::uint32_t version = 1; version <= PUBLISHES; version++) {
+			RenderSnapshot& snapshot = snapshots.beginWrite();
+			snapshot.capture(engine, version);
+			snapshot.score = static_cast<int>(version);		// must always match the version
+			snapshots.publish();
+		}
+	});
+	std::uint32_t lastVersion{ 0 };
+	while (lastVersion < PUBLISHES) {
+		if (snapshots.update()) {
+			const RenderSnapshot& snapshot = snapshots.read();
+			assert(snapshot.boardVersion > lastVersion && "TripleBuffer should only move forward");
+			assert(snapshot.score == static_cast<int>(snapshot.boardVersion) && "TripleBuffer handed out a torn snapshot");
+			lastVersion = snapshot.boardVersion;
+		}
+	}
+	writer.join();
+
+	announceTestCompletion();
+#else
+	announceNotTested("TripleBuffer");
+#endif
+}
+
+
+void TestSuite::testInputHandlerClass()
+{
+#ifdef INPUTHANDLER
+	announceTest("InputHandler");
+
+	// Gameboard.getShiftDistance() stops at walls & blocks
+	Gameboard board;
+	Point row[] = { Point(4, 10), Point(5, 10), Point(5, -1) };
+	assert(board.getShiftDistance(row, 3, -1) == 4 && board.getShiftDistance(row, 3, 1) == 4 && "Gameboard.getShiftDistance() walls failed");
+	board.setContent(1, 10, 0);
+	board.setContent(8, 10, 0);
+	assert(board.getShiftDistance(row, 3, -1) == 2 && board.getShiftDistance(row, 3, 1) == 2 && "Gameboard.getShiftDistance() blocks failed");
+
+	// DAS & ARR: one move on press, repeats start after DAS & follow every ARR until release
+	InputHandler::Config config;
+	config.dasSeconds = 0.1;
+	config.arrSeconds = 0.02;
+	TetrisEngine engine(21);
+	int spawnX{ engine.getCurrentShape().getGridLoc().getX() };
+	GridTetromino::BlockLocs locs = engine.getCurrentShape().getBlockLocsMappedToGrid();
+	int leftRoom{ engine.getBoard().getShiftDistance(locs.data(), 4, -1) };
+	InputHandler input(config);
+	input.press(GameInput::MoveLeft, 0.0);
+	input.press(GameInput::MoveLeft, 0.01);		// OS key repeat, ignored
+	input.update(engine, 0.05);
+	assert(engine.getCurrentShape().getGridLoc().getX() == spawnX - 1 && "InputHandler should move once on press");
+	input.update(engine, 0.121);
+	assert(engine.getCurrentShape().getGridLoc().getX() == spawnX - std::min(3, leftRoom) && "InputHandler should repeat after DAS every ARR");
+	input.release(GameInput::MoveLeft, 0.125);
+	int x{ engine.getCurrentShape().getGridLoc().getX() };
+	input.update(engine, 1.0);
+	assert(engine.getCurrentShape().getGridLoc().getX() == x && "InputHandler should stop repeating on release");
+
+	// several repeats can land within one logic step
+	config.dasSeconds = 0.0;
+	config.arrSeconds = 0.001;
+	TetrisEngine fast(21);
+	InputHandler fastInput(config);
+	fastInput.press(GameInput::MoveRight, 0.0);
+	fastInput.update(fast, 0.0025);
+	assert(fast.getCurrentShape().getGridLoc().getX() >= spawnX + 2 && "InputHandler should apply repeats sub-step");
+
+	// last pressed direction wins, and the other resumes when it is released
+	config.dasSeconds = 0.1;
+	config.arrSeconds = 0.02;
+	TetrisEngine both(21);
+	InputHandler bothInput(config);
+	bothInput.press(GameInput::MoveLeft, 0.0);
+	bothInput.press(GameInput::MoveRight, 0.05);
+	bothInput.update(both, 0.3);
+	assert(both.getCurrentShape().getGridLoc().getX() > spawnX && "InputHandler: the last pressed direction should win");
+	bothInput.release(GameInput::MoveRight, 0.3);
+	bothInput.update(both, 1.0);
+	locs = both.getCurrentShape().getBlockLocsMappedToGrid();
+	assert(both.getBoard().getShiftDistance(locs.data(), 4, -1) == 0 && "InputHandler: the held direction should resume");
+
+	// instant ARR slides to the wall in one move once DAS has passed
+	config.arrSeconds = 0.0;
+	TetrisEngine instant(21);
+	InputHandler instantInput(config);
+	instantInput.press(GameInput::MoveRight, 0.0);
+	instantInput.update(instant, 0.099);
+	assert(instant.getCurrentShape().getGridLoc().getX() == spawnX + 1 && "InputHandler instant ARR should wait for DAS");
+	instantInput.update(instant, 0.104);
+	locs = instant.getCurrentShape().getBlockLocsMappedToGrid();
+	assert(instant.getBoard().getShiftDistance(locs.data(), 4, 1) == 0 && "InputHandler instant ARR should reach the wall");
+	assert(instant.shiftToWall(GameInput::MoveRight) == 0 && "TetrisEngine.shiftToWall() at the wall should not move");
+
+	// one-shot inputs apply once, at their time
+	TetrisEngine oneShot(21);
+	InputHandler oneShotInput(config);
+	oneShotInput.press(GameInput::HardDrop, 0.01);
+	oneShotInput.update(oneShot, 0.005);
+	assert(oneShot.getPiecesPlaced() == 0 && "InputHandler applied an input before its time");
+	oneShotInput.update(oneShot, 0.02);
+	oneShot.step(0.0);
+	assert(oneShot.getPiecesPlaced() == 1 && "InputHandler should apply a hard drop once");
+
+	announceTestCompletion();
+#else
+	announceNotTested("InputHandler");
+#endif
+}
+
+
+void TestSuite::testStartupProfileClass()
+{
+#ifdef STARTUPPROFILE
+	announceTest("StartupProfile");
+
+	// stages recorded from several threads are all kept, with non-negative durations
+	StartupProfile profile;
+	std::thread worker([&profile]() {
+		StartupProfile::Scope scope(profile, "worker stage");
+	});
+	{
+		StartupProfile::Scope scope(profile, "main stage");
+	}
+	worker.join();
+	profile.mark("first frame");
+	assert(profile.stages.size() == 3 && "StartupProfile should keep every stage");
+	for (const StartupProfile::Stage& stage : profile.stages) {
+		assert(stage.startMs >= 0.0 && stage.endMs >= stage.startMs && "StartupProfile stage times out of order");
+	}
+	assert(profile.stages.back().startMs == profile.stages.back().endMs && "StartupProfile.mark() should record an instant");
+
+	std::ostringstream out;
+	profile.print(out);
+	assert(out.str().find("worker stage") != std::string::npos && out.str().find("first frame") != std::string::npos &&
+		"StartupProfile.print() should list every stage");
+
+	announceTestCompletion();
+#else
+	announceNotTested("StartupProfile");
+#endif
+}
+
+
+void TestSuite::testAssetArchiveClass()
+{
+#ifdef ASSETARCHIVE
+	announceTest("AssetArchive");
+
+	const char* const text{ "RedOctober" };
+	std::string binary(1000, '\0');
+	for (std::size_t i = 0; i < binary.size(); i++)
+		binary[i] = static_cast<char>(i * 7);
+	std::ofstream("testsuite.asset1", std::ios::binary) << text;
+	std::ofstream("testsuite.asset2", std::ios::binary) << binary;
+
+	// packed files are found by name, case insensitively, and read back unchanged from the mapping
+	assert(AssetArchive::pack("testsuite.pak", "", { "testsuite.asset1", "testsuite.asset2" }) && "AssetArchive::pack() failed");
+	AssetArchive archive;
+	assert(archive.open("testsuite.pak") && archive.getEntryCount() == 2 && "AssetArchive.open() failed");
+	const AssetArchive::Entry* entry = archive.find("TestSuite.Asset1");
+	assert(entry && entry->size == std::strlen(text) && std::memcmp(entry->data, text, entry->size) == 0 && "AssetArchive.find() text mismatch");
+	entry = archive.find("testsuite.asset2");
+	assert(entry && entry->size == binary.size() && std::memcmp(entry->data, binary.data(), entry->size) == 0 && "AssetArchive.find() binary mismatch");
+	assert(reinterpret_cast<std::uintptr_t>(entry->data) % 16 == 0 && "AssetArchive data should be aligned");
+	assert(archive.find("testsuite.asset3") == nullptr && "AssetArchive.find() of a missing name should fail");
+	archive.close();
+	assert(!archive.isOpen() && archive.find("testsuite.asset1") == nullptr && "AssetArchive.close() should drop the index");
+
+	// directories are listed file by file, for packing
+	std::vector<std::string> listed;
+	assert(AssetArchive::listFiles("", ".", listed) && "AssetArchive::listFiles() failed");
+	assert(std::count(listed.begin(), listed.end(), "./testsuite.asset1") == 1 && std::count(listed.begin(), listed.end(), "./testsuite.asset2") == 1 &&
+		std::count(listed.begin(), listed.end(), "./.") == 0 && std::is_sorted(listed.begin(), listed.end()) && "AssetArchive::listFiles() listed the wrong files");
+	assert(!AssetArchive::listFiles("", "testsuite.missing", listed) && "AssetArchive::listFiles() of a missing directory should fail");
+
+	// missing sources, missing & truncated archives are rejected
+	assert(!AssetArchive::pack("testsuite.pak", "", { "testsuite.missing" }) && "AssetArchive::pack() of a missing file should fail");
+	assert(!archive.open("testsuite.missing") && "AssetArchive.open() of a missing file should fail");
+	std::ofstream("testsuite.pak", std::ios::binary) << "TPAK\x01";
+	assert(!archive.open("testsuite.pak") && !archive.isOpen() && "AssetArchive.open() of a truncated archive should fail");
+
+	std::remove("testsuite.asset1");
+	std::remove("testsuite.asset2");
+	std::remove("testsuite.pak");
+
+	announceTestCompletion();
+#else
+	announceNotTested("AssetArchive");
+#endif
+}
+
+
+#ifdef BYTEGRID
+// Play random row fills, row copies & row removals on a Gameboard, whose color plane is a
+// ByteGrid, and on a plain int grid, and check the two always hold the same cells.
+template<int Width, int Height>
+void TestSuite::checkByteGridKernels(std::uint64_t seed)
+{
+	typedef ByteGrid<Width, Height> Grid;
+	const int empty{ Grid::EMPTY_CELL };
+	Pcg32 rng;
+	rng.seed(seed, 20);
+	BasicGameboard<Width, Height> board;
+	std::vector<std::vector<int>> reference(Height, std::vector<int>(Width, empty));
+	for (int round = 0; round < 50; round++) {
+		for (int y = 0; y < Height; y++) {
+			int holes{ static_cast<int>(rng.nextBelow(3)) };	// rows with 0 holes are completed
+			for (int x = 0; x < Width; x++) {
+				bool hole{ holes > 0 && static_cast<int>(rng.nextBelow(Width)) < holes };
+				reference[y][x] = hole ? empty : static_cast<int>(rng.nextBelow(7));
+				board.setContent(x, y, reference[y][x]);
+			}
+		}
+
+		int src{ static_cast<int>(rng.nextBelow(Height)) }, dst{ static_cast<int>(rng.nextBelow(Height)) };
+		board.copyRowIntoRow(src, dst);
+		reference[dst] = reference[src];
+		int filled{ static_cast<int>(rng.nextBelow(Height)) };
+		board.fillRow(filled, 3);
+		reference[filled].assign(Width, 3);
+
+		// removing the completed rows shifts the rows above them down
+		board.removeCompletedRows();
+		std::vector<std::vector<int>> kept;
+		for (const std::vector<int>& row : reference) {
+			if (std::count(row.begin(), row.end(), empty) > 0)
+				kept.push_back(row);
+		}
+		reference.assign(Height - kept.size(), std::vector<int>(Width, empty));
+		reference.insert(reference.end(), kept.begin(), kept.end());
+
+		for (int y = 0; y < Height; y++) {
+			for (int x = 0; x < Width; x++) {
+				assert(board.getContent(x, y) == reference[y][x] && "The ByteGrid color plane differs from an int grid");
+			}
+		}
+	}
+
+	// whole grid fills reach every cell
+	Grid grid;
+	grid.fill(0);
+	assert(grid.get(0, 0) == 0 && grid.get(Width - 1, Height - 1) == 0 && "ByteGrid.fill() failed");
+	grid.fill(empty);
+	assert(grid.get(0, 0) == empty && grid.get(Width - 1, Height - 1) == empty && "ByteGrid.fill() failed");
+}
+#endif
+
+void TestSuite::testByteGridClass()
+{
+#ifdef BYTEGRID
+	announceTest("ByteGrid");
+	std::cout << "(" << ByteGrid<10, 19>::getKernelName() << ")...";
+
+	static_assert(ByteGrid<10, 19>::ROW_STRIDE == 16 && ByteGrid<40, 100>::ROW_STRIDE == 48, "ByteGrid rows are padded to 16 bytes");
+	checkByteGridKernels<10, 19>(1);
+	checkByteGridKernels<32, 64>(2);
+	checkByteGridKernels<40, 100>(3);
 
+	announceTestCompletion();
+#else
+	announceNotTested("ByteGrid");
+#endif
+}
+
+
+
+#ifdef MOVEGENERATOR
+typedef std::vector<int> Footprint;	// Sorted cell indices (y * MAX_X + x) covered by a shape
+
+Footprint getFootprint(const GridTetromino& shape)
+{
+	Footprint cells;
+	for (const Point& p : shape.getBlockLocsMappedToGrid()) {
+		cells.push_back(p.getY() * Gameboard::MAX_X + p.getX());
+	}
+	std::sort(cells.begin(), cells.end());
+	return cells;
+}
+
+Footprint getFootprint(TetShape shape, const Placement& placement)
+{
+	GridTetromino copy;
+	copy.setShape(shape);
+	copy.setOrientation(placement.orientation);
+	copy.setGridLoc(placement.x, placement.y);
+	return getFootprint(copy);
+}
+
+// Fill a board with random columns of garbage, some of them overhanging an empty cell.
+void fillRandomStack(Gameboard& board, Pcg32& rng)
+{
+	board.empty();
+	for (int x = 0; x < Gameboard::MAX_X; x++) {
+		int height{ static_cast<int>(rng.nextBelow(Gameboard::MAX_Y - 2)) };	// up to the spawn rows
+		for (int y = Gameboard::MAX_Y - height; y < Gameboard::MAX_Y; y++) {
+			if (rng.nextBelow(4) != 0)
+				board.setContent(x, y, 1);
+		}
+	}
+	board.removeCompletedRows();
+}
+#endif
+
+void TestSuite::testMoveGeneratorClass()
+{
+#ifdef MOVEGENERATOR
+	announceTest("MoveGenerator");
+
+	// every column & distinct orientation of each shape on an empty board
+	MoveGenerator<10, 19> generator;
+	std::vector<Placement> placements;
+	const int emptyBoardCounts[static_cast<int>(TetShape::COUNT)] = { 17, 17, 34, 34, 9, 17, 34 };	// S, Z, L, J, O, I, T
+	for (int s = 0; s < static_cast<int>(TetShape::COUNT); s++) {
+		generator.generate(BitBoard<10, 19>(), static_cast<TetShape>(s), placements, true);
+		assert(static_cast<int>(placements.size()) == emptyBoardCounts[s] && "MoveGenerator should find every drop on an empty board");
+		for (const Placement& placement : placements) {
+			assert(!placement.tuck && "An empty board has no tucks");
+		}
+	}
+
+	// the placements match a search over GridTetrominos checked by the engine, on random stacks
+	TetrisEngine engine;
+	Pcg32 rng;
+	rng.seed(21, 21);
+	int tucksFound{ 0 };
+	for (int round = 0; round < 40; round++) {
+		fillRandomStack(engine.board, rng);
+		BitBoard<10, 19> bits(engine.board);
+		for (int s = 0; s < static_cast<int>(TetShape::COUNT); s++) {
+			TetShape shape{ static_cast<TetShape>(s) };
+			GridTetromino spawn;
+			spawn.setShape(shape);
+			spawn.setGridLoc(engine.board.getSpawnLoc());
+			if (!engine.isPositionLegal(spawn))
+				continue;
+
+			// hard drops: rotate at spawn, slide, drop
+			std::set<Footprint> drops;
+			GridTetromino rotated = spawn;
+			for (int orientation = 0; orientation < Tetromino::ORIENTATION_COUNT && engine.isPositionLegal(rotated); orientation++) {
+				for (int direction = -1; direction <= 1; direction += 2) {
+					for (GridTetromino slid = rotated; engine.isPositionLegal(slid); slid.move(direction, 0)) {
+						GridTetromino dropped = slid;
+						engine.drop(dropped);
+						drops.insert(getFootprint(dropped));
+					}
+				}
+				rotated.rotateClockwise();
+			}
+
+			// everything reachable with single moves
+			std::set<Footprint> resting;
+			std::set<std::vector<int>> visited{ { 0, spawn.getGridLoc().getX(), spawn.getGridLoc().getY() } };
+			std::vector<GridTetromino> queue{ spawn };
+			for (std::size_t next = 0; next < queue.size(); next++) {
+				GridTetromino below = queue[next];
+				below.move(0, 1);
+				if (!engine.isPositionLegal(below))
+					resting.insert(getFootprint(queue[next]));
+				const int moves[4][2] = { { -1, 0 }, { 1, 0 }, { 0, 1 }, { 0, 0 } };	// left, right, down, rotate
+				for (const int* move : moves) {
+					GridTetromino moved = queue[next];
+					moved.move(move[0], move[1]);
+					if (move[1] == 0 && move[0] == 0)
+						moved.rotateClockwise();
+					std::vector<int> state{ moved.getOrientation(), moved.getGridLoc().getX(), moved.getGridLoc().getY() };
+					if (engine.isPositionLegal(moved) && visited.insert(state).second)
+						queue.push_back(moved);
+				}
+			}
+
+			generator.generate(bits, shape, placements, false);
+			std::set<Footprint> generated;
+			for (const Placement& placement : placements) {
+				assert(!placement.tuck && bits.fits(PieceMask::get(shape, placement.orientation), placement.x, placement.y) && "MoveGenerator placements should fit");
+				generated.insert(getFootprint(shape, placement));
+			}
+			assert(generated.size() == placements.size() && "MoveGenerator should not repeat a placement");
+			assert(generated == drops && "MoveGenerator hard drops differ from the engine's");
+
+			generator.generate(bits, shape, placements, true);
+			generated.clear();
+			for (const Placement& placement : placements) {
+				Footprint cells{ getFootprint(shape, placement) };
+				assert(placement.tuck == (drops.count(cells) == 0) && "MoveGenerator should flag the placements hard drops can't reach");
+				tucksFound += placement.tuck;
+				generated.insert(cells);
+			}
+			assert(generated.size() == placements.size() && generated == resting && "MoveGenerator tucks differ from the engine's");
+		}
+	}
+	assert(tucksFound > 0 && "The random stacks should have overhangs to tuck under");
+
+	// placing on a BitBoard matches locking into a Gameboard
+	for (int round = 0; round < 100; round++) {
+		fillRandomStack(engine.board, rng);
+		BitBoard<10, 19> bits(engine.board);
+		TetShape shape{ static_cast<TetShape>(rng.nextBelow(static_cast<int>(TetShape::COUNT))) };
+		generator.generate(bits, shape, placements, true);
+		if (placements.empty())
+			continue;
+		const Placement& placement = placements[rng.nextBelow(static_cast<int>(placements.size()))];
+		GridTetromino locked;
+		locked.setShape(shape);
+		locked.setOrientation(placement.orientation);
+		locked.setGridLoc(placement.x, placement.y);
+		for (const Point& p : locked.getBlockLocsMappedToGrid()) {
+			engine.board.setContent(p, 1);
+		}
+		int rowsRemoved{ engine.board.removeCompletedRows() };
+		assert(bits.place(PieceMask::get(shape, placement.orientation), placement.x, placement.y) == rowsRemoved && "BitBoard.place() removed the wrong # of rows");
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			assert(bits.getRowMask(y) == engine.board.getRowMask(y) && "BitBoard.place() differs from the Gameboard");
+		}
+	}
+
+	// wider boards use the same tables
+	MoveGenerator<40, 100> wideGenerator;
+	wideGenerator.generate(BitBoard<40, 100>(), TetShape::T, placements, true);
+	assert(placements.size() == 4 * 40 - 6 && "MoveGenerator should find every drop on a wide board");
+
+	announceTestCompletion();
+#else
+	announceNotTested("MoveGenerator");
+#endif
+}
+
+void TestSuite::testPerftClass()
+{
+#ifdef PERFT
+	announceTest("Perft");
+
+	// known counts, from the generator and from the engine's own collision & line clear code
+	Perft empty(Benchmark::makeBoard(Benchmark::BoardFill::Empty), 1, 4, false);
+	const long long emptyNodes[] = { 17, 289, 2601, 88434 };
+	Perft garbage(Benchmark::makeBoard(Benchmark::BoardFill::Garbage), 1, 4, false);
+	const long long garbageNodes[] = { 17, 211, 1292, 21753 };
+	Perft tucks(Benchmark::makeBoard(Benchmark::BoardFill::Garbage), 1, 4, true);
+	const long long tuckNodes[] = { 17, 211, 1298, 26393 };
+	for (int depth = 1; depth <= 4; depth++) {
+		assert(empty.run(depth).nodes == emptyNodes[depth - 1] && "Perft node count changed on the empty board");
+		assert(garbage.run(depth).nodes == garbageNodes[depth - 1] && "Perft node count changed on the garbage board");
+		assert(tucks.run(depth).nodes == tuckNodes[depth - 1] && "Perft node count changed with tucks");
+	}
+	for (int depth = 1; depth <= 3; depth++) {
+		assert(empty.runReference(depth) == emptyNodes[depth - 1] && "Perft reference count differs on the empty board");
+		assert(garbage.runReference(depth) == garbageNodes[depth - 1] && "Perft reference count differs on the garbage board");
+	}
+	assert(tucks.runReference(2) == tuckNodes[1] && "Perft reference count differs with tucks");
+
+	// threads only change the throughput
+	Perft::Result serial = garbage.run(4, 1);
+	Perft::Result parallel = garbage.run(4, 4);
+	assert(parallel.threads == 4 && parallel.nodes == serial.nodes && parallel.divide == serial.divide && "Perft counts should not depend on the thread count");
+	long long divided{ 0 };
+	for (long long nodes : parallel.divide) {
+		divided += nodes;
+	}
+	assert(divided == parallel.nodes && static_cast<long long>(parallel.divide.size()) == garbageNodes[0] && "Perft divide should split the nodes by first placement");
+
+	announceTestCompletion();
+#else
+	announceNotTested("Perft");
+#endif
+}
+
+
+
+#ifdef HEURISTICPOLICY
+typedef BoardFeatures<Gameboard::MAX_X, Gameboard::MAX_Y> Features;
+typedef Features::Board FeatureBoard;
+
+// Check features against a count over every cell of the board.
+void checkFeatures(const Features& features, const FeatureBoard& board)
+{
+	auto isFilled = [&](int x, int y) {
+		if (x < 0 || x >= Gameboard::MAX_X || y >= Gameboard::MAX_Y)
+			return true;
+		return y >= 0 && (board.getRowMask(y) & Gameboard::getColumnBit(x)) != 0;
+	};
+	int holes{ 0 }, rowTransitions{ 0 }, columnTransitions{ 0 }, heights[Gameboard::MAX_X];
+	for (int x = 0; x < Gameboard::MAX_X; x++) {
+		heights[x] = 0;
+		for (int y = Gameboard::MAX_Y - 1; y >= 0; y--) {
+			if (isFilled(x, y))
+				heights[x] = Gameboard::MAX_Y - y;
+		}
+		for (int y = Gameboard::MAX_Y - heights[x]; y < Gameboard::MAX_Y; y++) {
+			holes += !isFilled(x, y);
+		}
+		assert(features.getColumnHeight(x) == heights[x] && "BoardFeatures column height is wrong");
+	}
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		for (int x = -1; x < Gameboard::MAX_X; x++) {
+			rowTransitions += isFilled(x, y) != isFilled(x + 1, y);
+			if (x >= 0)
+				columnTransitions += isFilled(x, y - 1) != isFilled(x, y);
+		}
+	}
+	for (int x = 0; x < Gameboard::MAX_X; x++) {
+		columnTransitions += isFilled(x, Gameboard::MAX_Y - 1) != isFilled(x, Gameboard::MAX_Y);
+	}
+	int bumpiness{ 0 }, wells{ 0 }, aggregateHeight{ 0 };
+	for (int x = 0; x < Gameboard::MAX_X; x++) {
+		aggregateHeight += heights[x];
+		if (x > 0)
+			bumpiness += std::abs(heights[x] - heights[x - 1]);
+		int left{ x > 0 ? heights[x - 1] : Gameboard::MAX_Y }, right{ x < Gameboard::MAX_X - 1 ? heights[x + 1] : Gameboard::MAX_Y };
+		for (int depth = 1; depth <= std::min(left, right) - heights[x]; depth++)
+			wells += depth;
+	}
+	assert(features.getHoles() == holes && "BoardFeatures holes are wrong");
+	assert(features.getRowTransitions() == rowTransitions && "BoardFeatures row transitions are wrong");
+	assert(features.getColumnTransitions() == columnTransitions && "BoardFeatures column transitions are wrong");
+	assert(features.getBumpiness() == bumpiness && features.getWells() == wells && features.getAggregateHeight() == aggregateHeight &&
+		"BoardFeatures column sums are wrong");
+}
+#endif
+
+void TestSuite::testHeuristicPolicyClass()
+{
+#ifdef HEURISTICPOLICY
+	announceTest("HeuristicPolicy");
+
+	// features computed from scratch & updated by place() match a count over every cell
+	MoveGenerator<Gameboard::MAX_X, Gameboard::MAX_Y> generator;
+	std::vector<Placement> placements;
+	Pcg32 rng;
+	rng.seed(23, 23);
+	int linesCleared{ 0 };
+	for (int round = 0; round < 20; round++) {
+		FeatureBoard board;
+		for (int y = Gameboard::MAX_Y / 2; y < Gameboard::MAX_Y; y++) {
+			FeatureBoard::RowMask holes = Gameboard::getColumnBit(rng.nextBelow(Gameboard::MAX_X)) | Gameboard::getColumnBit(rng.nextBelow(Gameboard::MAX_X));
+			board.setRowMask(y, static_cast<FeatureBoard::RowMask>(Gameboard::FULL_ROW_MASK & ~holes));	// one or two holes
+		}
+		board.removeCompletedRows(0, Gameboard::MAX_Y - 1);
+		Features features(board);
+		checkFeatures(features, board);
+		for (int piece = 0; piece < 30; piece++) {
+			TetShape shape{ static_cast<TetShape>(rng.nextBelow(static_cast<int>(TetShape::COUNT))) };
+			generator.generate(board, shape, placements, true);
+			if (placements.empty())
+				break;
+			const Placement& placement = placements[rng.nextBelow(static_cast<int>(placements.size()))];
+			const PieceMask& mask = PieceMask::get(shape, placement.orientation);
+			FeatureBoard expected = board;
+			int rows{ expected.place(mask, placement.x, placement.y) };
+			assert(features.place(board, mask, placement.x, placement.y) == rows && features.getLinesCleared() == rows && "BoardFeatures.place() removed the wrong # of rows");
+			for (int y = 0; y < Gameboard::MAX_Y; y++) {
+				assert(board.getRowMask(y) == expected.getRowMask(y) && "BoardFeatures.place() should place like BitBoard.place()");
+			}
+			checkFeatures(features, board);
+			linesCleared += rows;
+		}
+	}
+	assert(linesCleared > 0 && "BoardFeatures should have been tested with line clears");
+
+	// a well is filled by the shape that clears the most rows
+	TetrisEngine engine;
+	for (int y = Gameboard::MAX_Y - 4; y < Gameboard::MAX_Y; y++) {
+		for (int x = 0; x < Gameboard::MAX_X - 1; x++) {
+			engine.board.setContent(x, y, 1);
+		}
+	}
+	engine.currentShape.setShape(TetShape::I);
+	engine.currentShape.setOrientation(0);
+	engine.currentShape.setGridLoc(engine.board.getSpawnLoc());
+	HeuristicPolicy policy;
+	SelfPlayRunner::applyPlacement(engine, policy.choosePlacement(engine));
+	assert(engine.getLinesCleared() == 4 && "HeuristicPolicy should take the tetris");
+
+	// it plays on where random drops top out quickly
+	GameResult result = SelfPlayRunner::playGame(7, policy, 500);
+	assert(!result.toppedOut && result.piecesPlaced == 500 && result.linesCleared > 150 && "HeuristicPolicy should survive 500 pieces");
+
+	announceTestCompletion();
+#else
+	announceNotTested("HeuristicPolicy");
+#endif
+}
+
+void TestSuite::testBeamSearchPolicyClass()
+{
+#ifdef BEAMSEARCH
+	announceTest("BeamSearchPolicy");
+
+	// the pool runs every task of every batch once, on every thread
+	ThreadPool pool(4);
+	assert(pool.getThreadCount() == 4 && "ThreadPool should count the caller as a thread");
+	for (int batch = 0; batch < 20; batch++) {
+		std::vector<std::atomic<int>> runs(37);
+		for (std::atomic<int>& r : runs) {
+			r = 0;
+		}
+		std::atomic<int> badThread{ 0 };
+		pool.run(static_cast<int>(runs.size()), [&](int task, int thread) {
+			runs[task]++;
+			badThread += thread < 0 || thread >= 4;
+		});
+		for (std::atomic<int>& r : runs) {
+			assert(r == 1 && "ThreadPool.run() should run every task once");
+		}
+		assert(badThread == 0 && "ThreadPool.run() passed a bad thread index");
+	}
+
+	// a one board beam over one shape is the heuristic policy
+	BeamSearchPolicy::Config greedy;
+	greedy.beamWidth = 1;
+	greedy.depth = 1;
+	BeamSearchPolicy greedySearch(greedy);
+	HeuristicPolicy heuristic;
+	for (int f = 0; f < static_cast<int>(Benchmark::BoardFill::COUNT); f++) {
+		TetrisEngine engine(static_cast<std::uint64_t>(f));
+		engine.board = Benchmark::makeBoard(static_cast<Benchmark::BoardFill>(f));
+		Placement a = greedySearch.choosePlacement(engine), b = heuristic.choosePlacement(engine);
+		assert(a.orientation == b.orientation && a.x == b.x && a.y == b.y && "BeamSearchPolicy with a beam of 1 should play like HeuristicPolicy");
+	}
+
+	// the threads only change the speed; the search is allocation free once warm
+	BeamSearchPolicy::Config config;
+	config.beamWidth = 16;
+	config.depth = 3;
+	config.threads = 1;
+	BeamSearchPolicy serial(config);
+	config.threads = 4;
+	BeamSearchPolicy parallel(config);
+	TetrisEngine serialGame(9), parallelGame(9);
+	for (int piece = 0; piece < 200; piece++) {
+		std::size_t allocations{ Benchmark::getAllocationCount() };
+		Placement a = serial.choosePlacement(serialGame);
+		assert((piece == 0 || Benchmark::getAllocationCount() == allocations) && "BeamSearchPolicy should not allocate once warm");
+		Placement b = parallel.choosePlacement(parallelGame);
+		assert(a.orientation == b.orientation && a.x == b.x && serial.getStats().nodes == parallel.getStats().nodes &&
+			"BeamSearchPolicy should not depend on the thread count");
+		SelfPlayRunner::applyPlacement(serialGame, a);
+		SelfPlayRunner::applyPlacement(parallelGame, b);
+	}
+	assert(serialGame.getGameLoopState() == GameLoopState::Playing && serialGame.getScore() == parallelGame.getScore() &&
+		serialGame.getLinesCleared() > 60 && "BeamSearchPolicy should keep playing");
+	assert(serial.getStats().nodes > config.beamWidth && serial.getStats().nodesPerSecond > 0 && "BeamSearchPolicy stats are wrong");
+
+	announceTestCompletion();
+#else
+	announceNotTested("BeamSearchPolicy");
+#endif
+}
+
+#ifdef ZOBRIST
+// Hash a board from scratch, from its row masks.
+template<typename Board>
+std::uint64_t hashRows(const Board& board)
+{
+	const ZobristKeys<Gameboard::MAX_X, Gameboard::MAX_Y>& keys = ZobristKeys<Gameboard::MAX_X, Gameboard::MAX_Y>::get();
+	std::uint64_t hash{ 0 };
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		hash ^= keys.getRowKey(y, board.getRowMask(y));
+	}
+	return hash;
+}
+#endif
+
+void TestSuite::testZobristClass()
+{
+#ifdef ZOBRIST
+	announceTest("Zobrist");
+
+	// the gameboard's hash follows setContent(), row fills & row removal
+	Pcg32 rng;
+	rng.seed(25, 25);
+	Gameboard board;
+	assert(board.getHash() == 0 && "An empty board should hash to 0");
+	for (int i = 0; i < 2000; i++) {
+		int x{ static_cast<int>(rng.nextBelow(Gameboard::MAX_X)) }, y{ static_cast<int>(rng.nextBelow(Gameboard::MAX_Y)) };
+		board.setContent(x, y, rng.nextBelow(3) ? static_cast<int>(rng.nextBelow(static_cast<int>(TetColor::COUNT))) : Gameboard::EMPTY_BLOCK);
+		if (i % 100 == 0) {
+			board.fillRow(static_cast<int>(rng.nextBelow(Gameboard::MAX_Y)), 1);
+			board.removeCompletedRows();
+		}
+		assert(board.getHash() == hashRows(board) && "Gameboard hash is out of date");
+	}
+	board.empty();
+	assert(board.getHash() == 0 && "An emptied board should hash to 0");
+
+	// the keys are pinned, so hashes match across compilers & platforms
+	typedef ZobristKeys<Gameboard::MAX_X, Gameboard::MAX_Y> Keys;
+	board.setContent(0, 0, 1);
+	assert(Keys::get().getCellKey(0, 0) == 0xc883c00766d8aef3ull && "Zobrist keys changed");
+	assert(board.getHash() == 0xc883c00766d8aef3ull && "A board with one cell should hash to that cell's key");
+	board.empty();
+
+	// the same cells hash the same whatever order they're filled in, & colors aren't hashed
+	Gameboard reversed;
+	for (int x = 0; x < Gameboard::MAX_X - 1; x++) {
+		board.setContent(x, Gameboard::MAX_Y - 1, 1);
+		reversed.setContent(Gameboard::MAX_X - 2 - x, Gameboard::MAX_Y - 1, 2);
+	}
+	assert(board.getHash() == reversed.getHash() && board.getHash() != 0 && "Equal boards should hash the same");
+
+	// bit boards keep the gameboard's hash through placements & clears
+	typedef BeamSearchPolicy::Board Bits;
+	MoveGenerator<Gameboard::MAX_X, Gameboard::MAX_Y> generator;
+	std::vector<Placement> placements;
+	int rowsCleared{ 0 };
+	Bits bits(board);
+	assert(bits.getHash() == board.getHash() && "BitBoard should start from the gameboard's hash");
+	for (int piece = 0; piece < 300; piece++) {
+		TetShape shape{ static_cast<TetShape>(rng.nextBelow(static_cast<int>(TetShape::COUNT))) };
+		generator.generate(bits, shape, placements, true);
+		if (placements.empty()) {
+			bits = Bits();
+			continue;
+		}
+		const Placement& placement = placements[rng.nextBelow(static_cast<int>(placements.size()))];
+		rowsCleared += bits.place(PieceMask::get(shape, placement.orientation), placement.x, placement.y);
+		assert(bits.getHash() == hashRows(bits) && "BitBoard hash is out of date");
+	}
+	assert(rowsCleared > 0 && "BitBoard hashes should have been tested with row clears");
+
+	// the table keeps the best score per key, until the next search
+	TranspositionTable table(4);
+	const std::uint64_t key{ 0x123456789ABCDEF0ull };
+	float score{ 0 };
+	assert(!table.probe(key, score) && "An empty table should find nothing");
+	assert(table.store(key, 2.0f) == 2.0f && table.store(key, 1.0f) == 2.0f && table.store(key, 3.5f) == 3.5f &&
+		"TranspositionTable.store() should return the best score");
+	assert(table.probe(key, score) && score == 3.5f && "TranspositionTable.probe() should find the best score");
+	assert(!table.probe(key ^ (std::uint64_t(1) << 20), score) && table.store(key ^ (std::uint64_t(1) << 20), 1.0f) == 1.0f &&
+		"TranspositionTable should compare whole keys");
+	table.newSearch();
+	assert(!table.probe(key, score) && table.store(key, -1.0f) == -1.0f && "A new search should ignore older entries");
+
+	// a full bucket replaces its lowest score
+	table.clear();
+	for (int i = 0; i <= TranspositionTable::BUCKET_ENTRIES; i++) {
+		table.store((std::uint64_t(i + 1) << 40) | 5, static_cast<float>(i));
+	}
+	assert(!table.probe((std::uint64_t(1) << 40) | 5, score) && "TranspositionTable should replace the lowest score");
+	for (int i = 1; i <= TranspositionTable::BUCKET_ENTRIES; i++) {
+		assert(table.probe((std::uint64_t(i + 1) << 40) | 5, score) && score == i && "TranspositionTable lost a better entry");
+	}
+	for (int search = 0; search < 600; search++) {
+		table.newSearch();
+	}
+	assert(!table.probe((std::uint64_t(2) << 40) | 5, score) && "Entries should not outlive 255 searches");
+
+	// threads storing at once only find scores stored for their key
+	TranspositionTable shared(10);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([&shared, t]() {
+			for (int i = 0; i < 20000; i++) {
+				int k{ i % 3000 };
+				std::uint64_t hashed{ static_cast<std::uint64_t>(k) * 0x9E3779B97F4A7C15ull };
+				float stored{ static_cast<float>(k * 10 + (i * 7 + t) % 10) };
+				float best{ shared.store(hashed, stored) };
+				assert(best >= stored && static_cast<int>(best) / 10 == k && "TranspositionTable mixed up keys");
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	int found{ 0 };
+	for (int k = 0; k < 3000; k++) {
+		if (shared.probe(static_cast<std::uint64_t>(k) * 0x9E3779B97F4A7C15ull, score)) {
+			assert(static_cast<int>(score) / 10 == k && "TranspositionTable mixed up keys");
+			found++;
+		}
+	}
+	assert(found > 2500 && "TranspositionTable lost too many entries");
+
+	// the beam keeps one copy of each board, & plays as well as without pruning
+	BeamSearchPolicy::Config config;
+	config.depth = 3;
+	BeamSearchPolicy pruned(config);
+	config.pruneDuplicates = false;
+	BeamSearchPolicy unpruned(config);
+	TetrisEngine prunedGame(3), unprunedGame(3);
+	long long duplicates{ 0 };
+	for (int piece = 0; piece < 100; piece++) {
+		SelfPlayRunner::applyPlacement(prunedGame, pruned.choosePlacement(prunedGame));
+		SelfPlayRunner::applyPlacement(unprunedGame, unpruned.choosePlacement(unprunedGame));
+		duplicates += pruned.getStats().duplicates;
+		assert(unpruned.getStats().duplicates == 0 && "BeamSearchPolicy should not prune when told not to");
+		for (int i = 0; i < static_cast<int>(pruned.beam.size()); i++) {
+			for (int j = 0; j < i; j++) {
+				assert(pruned.beam[i].board.getHash() != pruned.beam[j].board.getHash() && "BeamSearchPolicy kept a duplicate board");
+			}
+		}
+	}
+	assert(duplicates > 0 && "BeamSearchPolicy should have found duplicate boards");
+	assert(prunedGame.getGameLoopState() == GameLoopState::Playing && unprunedGame.getGameLoopState() == GameLoopState::Playing &&
+		"BeamSearchPolicy should keep playing with & without pruning");
+
+	announceTestCompletion();
+#else
+	announceNotTested("Zobrist");
+#endif
+}
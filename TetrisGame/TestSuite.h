@@ -10,7 +10,23 @@
 //#define TETROMINO
 //#define GAMEBOARD
 #define GRIDTETROMINO
+//#define TETRISENGINE
+//#define RANDOMIZER
+//#define REPLAY
+//#define SELFPLAY
+//#define BENCHMARK
+//#define TRIPLEBUFFER
+//#define INPUTHANDLER
+//#define STARTUPPROFILE
+//#define ASSETARCHIVE
+//#define BYTEGRID
+//#define MOVEGENERATOR
+//#define PERFT
+//#define HEURISTICPOLICY
+//#define BEAMSEARCH
+//#define ZOBRIST
 
+#include <cstdint>
 #include <string>
 
 class TestSuite {
@@ -21,6 +37,23 @@ private:
 	static void testTetrominoClass();	// tests for the Tetromino class
 	static void testGameboardClass();
 	static void testGridTetrominoClass(); // tests for the GridTetromino class
+	static void testTetrisEngineClass();  // tests for the headless TetrisEngine class
+	static void testRandomizerClass();	  // tests for the Pcg32 & Randomizer classes
+	static void testReplayClass();		  // tests for the Replay & ReplayPlayer classes
+	static void testSelfPlayRunnerClass();  // tests for the SelfPlayRunner class
+	static void testBenchmarkClass();	  // tests for the Benchmark fixtures
+	static void testTripleBufferClass();  // tests for the TripleBuffer class
+	static void testInputHandlerClass();  // tests for the InputHandler class (DAS/ARR)
+	static void testStartupProfileClass();  // tests for the StartupProfile class
+	static void testAssetArchiveClass();  // tests for the AssetArchive class
+	static void testByteGridClass();	  // tests for the ByteGrid kernels
+	template<int Width, int Height>
+	static void checkByteGridKernels(std::uint64_t seed);	// ByteGrid color plane vs an int grid
+	static void testMoveGeneratorClass();  // tests for the BitBoard & MoveGenerator classes
+	static void testPerftClass();		  // known node counts of the Perft class
+	static void testHeuristicPolicyClass();  // tests for the BoardFeatures & HeuristicPolicy classes
+	static void testBeamSearchPolicyClass();  // tests for the ThreadPool & BeamSearchPolicy classes
+	static void testZobristClass();	  // tests for board hashing & the TranspositionTable class
 
 	static void announceTest(const std::string& className);
 	static void announceTestCompletion();
@@ -0,0 +1,313 @@
+#include "TetrisEngine.h"
+#include "Replay.h"
+#include <algorithm>
+
+
+// STATIC CONSTANTS ======================================
+
+template<int Width, int Height>
+const double BasicTetrisEngine<Width, Height>::MAX_SECONDS_PER_TICK{ 0.75 };
+template<int Width, int Height>
+const double BasicTetrisEngine<Width, Height>::MIN_SECONDS_PER_TICK{ 0.20 };
+template<int Width, int Height>
+const double BasicTetrisEngine<Width, Height>::GAME_OVER_RESET_SECONDS{ 4.0 };
+
+// CONSTRUCTOR -------------------------------------------
+
+template<int Width, int Height>
+BasicTetrisEngine<Width, Height>::BasicTetrisEngine(std::uint64_t seed)
+	: randomizer(seed)
+{
+	reset();
+}
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+template<int Width, int Height>
+void BasicTetrisEngine<Width, Height>::handleInput(GameInput input) {
+	if (gameLoopState != GameLoopState::Playing || shapePlacedSinceLastGameLoop) {
+		return;		// the locked shape stays put until the next step spawns a new one
+	}
+	if (recorder) {
+		recorder->record(static_cast<ReplayEventKind>(input), elapsedSeconds);
+	}
+
+	switch (input) {
+		case GameInput::RotateClockwise:
+			if (attemptRotate(currentShape)) {
+				raiseEvent(GameEvent::ShapeRotated);
+			}
+			break;
+		case GameInput::MoveLeft:
+			attemptMove(currentShape, -1, 0);
+			break;
+		case GameInput::MoveRight:
+			attemptMove(currentShape, 1, 0);
+			break;
+		case GameInput::SoftDrop:
+			attemptMove(currentShape, 0, 1);
+			break;
+		case GameInput::HardDrop:
+			drop(currentShape);
+			lock(currentShape);
+			break;
+	}
+}
+
+template<int Width, int Height>
+int BasicTetrisEngine<Width, Height>::shiftToWall(GameInput direction) {
+	assert(direction == GameInput::MoveLeft || direction == GameInput::MoveRight);
+	if (gameLoopState != GameLoopState::Playing || shapePlacedSinceLastGameLoop) {
+		return 0;
+	}
+
+	GridTetromino::BlockLocs locs = currentShape.getBlockLocsMappedToGrid();
+	int dx{ direction == GameInput::MoveLeft ? -1 : 1 };
+	int distance{ board.getShiftDistance(locs.data(), static_cast<int>(locs.size()), dx) };
+	if (recorder) {
+		for (int i = 0; i < distance; i++) {
+			recorder->record(static_cast<ReplayEventKind>(direction), elapsedSeconds);
+		}
+	}
+	if (distance > 0) {
+		currentShape.move(dx * distance, 0);
+		ghostShapeDirty = true;
+	}
+	return distance;
+}
+
+template<int Width, int Height>
+void BasicTetrisEngine<Width, Height>::step(double seconds) {
+	elapsedSeconds += seconds;
+	if (gameLoopState == GameLoopState::Playing) {
+		if (shapePlacedSinceLastGameLoop) {		// placed by an input since the last step
+			processPlacedShape();
+		}
+
+		// Catch up on every tick that is due, so gravity keeps pace after a long step.
+		secondsSinceLastTick += seconds;
+		while (gameLoopState == GameLoopState::Playing && secondsSinceLastTick > secondsPerTick) {
+			tick();
+			secondsSinceLastTick -= secondsPerTick;
+			if (shapePlacedSinceLastGameLoop) {
+				processPlacedShape();
+			}
+		}
+	}
+	else if (gameLoopState == GameLoopState::GameOver) {
+		secondsSinceGameOver += seconds;
+		if (secondsSinceGameOver >= GAME_OVER_RESET_SECONDS) {
+			gameLoopState = GameLoopState::Resetting;
+			if (recorder) {
+				recorder->record(ReplayEventKind::Reset, elapsedSeconds);
+			}
+			reset();
+		}
+	}
+}
+
+template<int Width, int Height>
+void BasicTetrisEngine<Width, Height>::tick() {
+	if (recorder) {
+		recorder->record(ReplayEventKind::Tick, elapsedSeconds);
+	}
+	if (!attemptMove(currentShape, 0, 1)) {
+		lock(currentShape);
+	}
+}
+
+template<int Width, int Height>
+void BasicTetrisEngine<Width, Height>::reset() {
+	gameLoopState = GameLoopState::Playing;
+	score = 0;
+	piecesPlaced = 0;
+	linesCleared = 0;
+	secondsSinceLastTick = 0.0;
+	secondsSinceGameOver = 0.0;
+	shapePlacedSinceLastGameLoop = false;
+	determineSecondsPerTick();
+	board.empty();
+	pickNextShape();
+	spawnNextShape();
+	pickNextShape();
+	raiseEvent(GameEvent::GameReset);
+}
+
+template<int Width, int Height>
+int BasicTetrisEngine<Width, Height>::getScoresFromRows(int rows) const {
+	switch (rows) {
+		case 1: return 100;
+		case 2: return 300;
+		case 3: return 500;
+		case 4: return 800;
+		default: return 0;
+	}
+}
+
+template<int Width, int Height>
+unsigned int BasicTetrisEngine<Width, Height>::takeEvents() {
+	unsigned int events{ pendingEvents };
+	pendingEvents = 0;
+	return events;
+}
+
+template<int Width, int Height>
+double BasicTetrisEngine<Width, Height>::getTickProgress() const {
+	return std::min(std::max(secondsSinceLastTick / secondsPerTick, 0.0), 1.0);
+}
+
+template<int Width, int Height>
+const GridTetromino& BasicTetrisEngine<Width, Height>::getGhostShape() const {
+	if (ghostShapeDirty) {
+		updateGhostShape();
+	}
+	return ghostShape;
+}
+
+// PRIVATE METHODS ---------------------------------------
+
+template<int Width, int Height>
+void BasicTetrisEngine<Width, Height>::pickNextShape() {
+	nextShape.setShape(randomizer.nextShape());
+	nextShape.setColor(randomizer.nextColor());
+}
+
+template<int Width, int Height>
+bool BasicTetrisEngine<Width, Height>::spawnNextShape() {
+	currentShape = nextShape;
+	currentShape.setGridLoc(board.getSpawnLoc());
+	ghostShapeDirty = true;
+	return isPositionLegal(currentShape);
+}
+
+template<int Width, int Height>
+void BasicTetrisEngine<Width, Height>::processPlacedShape() {
+	if (recorder) {
+		recorder->record(ReplayEventKind::ShapePlaced, elapsedSeconds);
+	}
+	shapePlacedSinceLastGameLoop = false;
+	piecesPlaced++;
+	if (spawnNextShape()) {
+		pickNextShape();
+		int rowsRemoved{ board.removeCompletedRows() };
+		if (rowsRemoved > 0) {
+			score += getScoresFromRows(rowsRemoved);
+			linesCleared += rowsRemoved;
+			ghostShapeDirty = true;
+			raiseEvent(GameEvent::RowsCleared);
+		}
+		determineSecondsPerTick();
+	}
+	else {
+		gameLoopState = GameLoopState::GameOver;
+		secondsSinceGameOver = 0.0;
+		raiseEvent(GameEvent::GameOver);
+	}
+}
+
+template<int Width, int Height>
+bool BasicTetrisEngine<Width, Height>::attemptRotate(GridTetromino& shape) {
+	GridTetromino copy = shape;
+	copy.rotateClockwise();
+
+	if (isPositionLegal(copy)) {
+		shape.rotateClockwise();
+		ghostShapeDirty = true;
+		return true;
+	}
+
+	return false;
+}
+
+template<int Width, int Height>
+bool BasicTetrisEngine<Width, Height>::attemptMove(GridTetromino& shape, int x, int y) {
+	GridTetromino copy = shape;
+	copy.move(x, y);
+
+	if (isPositionLegal(copy)) {
+		shape.move(x, y);
+		ghostShapeDirty = true;
+		return true;
+	}
+	return false;
+}
+
+template<int Width, int Height>
+void BasicTetrisEngine<Width, Height>::drop(GridTetromino& shape) const {
+	GridTetromino::BlockLocs locs = shape.getBlockLocsMappedToGrid();
+	shape.move(0, board.getDropDistance(locs.data(), static_cast<int>(locs.size())));
+}
+
+template<int Width, int Height>
+void BasicTetrisEngine<Width, Height>::lock(GridTetromino& shape) {
+	for (const Point& p : shape.getBlockLocsMappedToGrid()) {
+		board.setContent(p, static_cast<int>(shape.getColor()));
+	}
+	shapePlacedSinceLastGameLoop = true;
+	ghostShapeDirty = true;
+	raiseEvent(GameEvent::ShapeLocked);
+}
+
+template<int Width, int Height>
+void BasicTetrisEngine<Width, Height>::updateGhostShape() const {
+	ghostShape = currentShape;
+	drop(ghostShape);
+	ghostShapeDirty = false;
+}
+
+// STATE & GAMEPLAY/LOGIC METHODS ----------------------------
+
+template<int Width, int Height>
+bool BasicTetrisEngine<Width, Height>::isPositionLegal(const GridTetromino& shape) const {
+	for (const Point& p : shape.getBlockLocsMappedToGrid()) {
+		if (p.getX() < 0 || p.getX() > board.MAX_X - 1 || p.getY() > board.MAX_Y - 1) {
+			return false;
+		}
+		if (!board.isRowMaskClear(p.getY(), Board::getColumnBit(p.getX()))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template<int Width, int Height>
+bool BasicTetrisEngine<Width, Height>::isWithinBorders(const GridTetromino& shape) const {
+	for (const Point& p : shape.getBlockLocsMappedToGrid()) {
+		if (p.getX() < 0 || p.getX() > board.MAX_X - 1 || p.getY() > board.MAX_Y - 1) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template<int Width, int Height>
+void BasicTetrisEngine<Width, Height>::determineSecondsPerTick() {
+	double previousSecondsPerTick{ secondsPerTick };
+	if (score <= 100) {
+		secondsPerTick = MAX_SECONDS_PER_TICK;
+	}
+	else if (score < 500) {
+		secondsPerTick = MAX_SECONDS_PER_TICK * 0.9;
+	}
+	else if (score < 1000) {
+		secondsPerTick = MAX_SECONDS_PER_TICK * 0.8;
+	}
+	else if (score < 1500) {
+		secondsPerTick = MAX_SECONDS_PER_TICK * 0.7;
+	}
+	else if (score < 2000) {
+		secondsPerTick = MAX_SECONDS_PER_TICK * 0.6;
+	}
+	else {
+		secondsPerTick = MIN_SECONDS_PER_TICK;
+	}
+	if (secondsPerTick < previousSecondsPerTick) {
+		raiseEvent(GameEvent::LevelUp);
+	}
+}
+
+// EXPLICIT INSTANTIATIONS -------------------------------
+
+template class BasicTetrisEngine<10, 19>;	// TetrisEngine
+template class BasicTetrisEngine<32, 64>;
+template class BasicTetrisEngine<40, 100>;
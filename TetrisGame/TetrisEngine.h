@@ -0,0 +1,219 @@
+#pragma once
+
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "Randomizer.h"
+
+class Replay;
+
+enum class GameLoopState {
+	Playing,
+	GameOver,
+	Resetting
+};
+
+// Player commands understood by the engine.
+enum class GameInput {
+	RotateClockwise,
+	MoveLeft,
+	MoveRight,
+	SoftDrop,
+	HardDrop
+};
+
+// Things that happened inside the engine that a front end may want to react to (sounds, score text).
+// Used as bit flags, accumulated by the engine until TetrisEngine::takeEvents() is called.
+enum class GameEvent : unsigned int {
+	ShapeRotated = 1 << 0,	// The current shape was rotated.
+	ShapeLocked  = 1 << 1,	// The current shape was locked into the board.
+	RowsCleared  = 1 << 2,	// One or more rows were removed (score changed).
+	GameOver     = 1 << 3,	// The next shape could not spawn.
+	GameReset    = 1 << 4,	// A new game was started.
+	LevelUp      = 1 << 5	// The score reached a faster tick rate.
+};
+
+// Determine if an event is present in a set of events returned by TetrisEngine::takeEvents().
+inline bool hasEvent(unsigned int events, GameEvent event) {
+	return (events & static_cast<unsigned int>(event)) != 0;
+}
+
+/*
+ * The BasicTetrisEngine class template holds the rules of the game: the board, the current/next/
+ * ghost shapes, scoring, the tick rate and the game loop state machine. It has no graphics or audio
+ * dependencies, so it can be stepped headless (bots, simulations, tests) as fast as the CPU allows.
+ * Front ends feed it inputs & elapsed time and read its state back to draw it.
+ * The board dimensions are template parameters so wide variants cost nothing at runtime; the
+ * member functions are explicitly instantiated in TetrisEngine.cpp for the sizes listed there.
+ * The game itself uses the TetrisEngine typedef below.
+ */
+template<int Width, int Height>
+class BasicTetrisEngine {
+	friend class TestSuite;
+	friend class ReplayPlayer;
+	friend class Benchmark;
+	friend class Perft;
+
+public:
+	typedef BasicGameboard<Width, Height> Board;
+
+	// Static Constants ============================================================================
+	static const double MAX_SECONDS_PER_TICK;		// The slowest "tick" rate (in seconds)
+	static const double MIN_SECONDS_PER_TICK;		// The fastest "tick" rate (in seconds)
+	static const double GAME_OVER_RESET_SECONDS;	// Time spent in the GameOver state before resetting
+
+private:
+	// State members ===============================================================================
+	int score;							// The current game score.
+	Board board;						// The gameboard (grid) to represent where all the blocks are.
+	GridTetromino currentShape;			// The tetromino that is currently falling.
+	GridTetromino nextShape;			// The tetromino that is "on deck".
+	mutable GridTetromino ghostShape;	// The tetromino that displays where the currentShape will fall.
+	mutable bool ghostShapeDirty{ true };	// Set when the currentShape moves or the board changes.
+	GameLoopState gameLoopState;
+	Randomizer randomizer;				// Deals the shapes & colors of this game.
+	unsigned int pendingEvents{ 0 };	// GameEvent flags not yet collected by takeEvents().
+	Replay* recorder{ nullptr };		// Receives every state changing event when set.
+	int piecesPlaced{ 0 };				// # of shapes locked since the last reset.
+	int linesCleared{ 0 };				// # of rows removed since the last reset.
+
+	// Time members ================================================================================
+	double secondsPerTick = MAX_SECONDS_PER_TICK;	// The seconds per tick (Time for block to fall one line)
+	double secondsSinceLastTick{ 0.0 };				// To determine if its time to tick
+	double secondsSinceGameOver{ 0.0 };				// Forces game to reset after the gameOver sound
+	double elapsedSeconds{ 0.0 };					// Total stepped time, used to timestamp recorded events
+	bool shapePlacedSinceLastGameLoop{ false };		// Tracks whether a shape has been placed in the current gameloop
+
+public:
+	// Constructor
+	// Resets the game to its initial State
+	// @param seed: Seed of the game's randomizer, equal seeds (and inputs) play equal games.
+	explicit BasicTetrisEngine(std::uint64_t seed = 0);
+
+	// Applies a player command to the current shape. Ignored unless the game is Playing, and from a
+	// hard drop until the next step() spawns the next shape.
+	// @param input: The command to apply.
+	void handleInput(GameInput input);
+
+	// Slides the current shape sideways as far as it can go in one move (instant auto-repeat).
+	// Recorded as the equivalent run of single moves, so replays don't need a new event kind.
+	// Ignored unless the game is Playing, and from a hard drop until the next step().
+	// @param direction: GameInput::MoveLeft or GameInput::MoveRight.
+	// @return: The number of columns moved.
+	int shiftToWall(GameInput direction);
+
+	// Advances the game by some amount of time: handles ticks & tetromino placement/ locking,
+	// line clears, game over and the automatic reset after a game over.
+	// Every tick that falls due during the step is run, each placed shape being processed
+	// before the next tick, so the result only depends on the total time stepped.
+	// @param seconds: Time elapsed since the last step.
+	void step(double seconds);
+
+	// A tick forces the currentShape to move down by one square. If not successfull,
+	// it is locked into the gameboard.
+	void tick();
+
+	// Reset everything for a new game
+	//  - Clear the gameboard and set the score to 0.
+	//  - Determine the tick rate.
+	//  - Pick and spawn the next shape and pick the shape on deck.
+	void reset();
+
+	// Returns the corresponding score for the amount of rows completed at once.
+	// @param rows: The amount of completed rows on the board.
+	// @return: The score attained from the amount of rows comppleted.
+	int getScoresFromRows(int rows) const;
+
+	// Record every state changing event (inputs, ticks, placements, resets) into a replay.
+	// The replay should be started with this engine's seed before its first event.
+	// @param replay: The replay to record into, or nullptr to stop recording.
+	void setRecorder(Replay* replay) { recorder = replay; }
+
+	// Collect (and clear) the GameEvent flags raised since the last call.
+	// @return: A bitwise OR of GameEvent values.
+	unsigned int takeEvents();
+
+	// Accessors ===================================================================================
+
+	const Board& getBoard() const { return board; }
+	const GridTetromino& getCurrentShape() const { return currentShape; }
+	const GridTetromino& getNextShape() const { return nextShape; }
+
+	// Get the ghost shape, recomputing it first if the current shape or the board changed.
+	const GridTetromino& getGhostShape() const;
+
+	int getScore() const { return score; }
+	GameLoopState getGameLoopState() const { return gameLoopState; }
+	double getSecondsPerTick() const { return secondsPerTick; }
+
+	// Get how far the game is into the current tick interval, for smooth rendering of gravity.
+	// @return: 0 right after a tick, up to 1 when the next tick is due.
+	double getTickProgress() const;
+
+	const Randomizer& getRandomizer() const { return randomizer; }
+	int getPiecesPlaced() const { return piecesPlaced; }
+	int getLinesCleared() const { return linesCleared; }
+	double getElapsedSeconds() const { return elapsedSeconds; }
+
+private:
+	// Selects a random tetShape and tetColor for the next Shape to be used in the game.
+	void pickNextShape();
+
+	// copy the nextShape into the currentShape (through assignment)
+	//   position the currentShape to its spawn location.
+	//	 @return: True/false based on if currentShape is in a legal position.
+	bool spawnNextShape();
+
+	// Called once a shape was placed: spawns the next shape and removes completed rows,
+	// or ends the game if the next shape can't spawn.
+	void processPlacedShape();
+
+	// Test to see if a rotation is legal on the tetromino and if so, rotates it.
+	// @param shape: The tetromino shape that is attempting to rotate.
+	// @return: True/false based on if tetromino rotated or not.
+	bool attemptRotate(GridTetromino& shape);
+
+	// Test to see if a movement is legal on the tetromino and if so, moves it.
+	// @param shape: The tetromino shape that is attempting to move.
+	// @param x: The horizontal direction the tetromino shape is attempting to move.
+	// @param y: The vertical direction the tetromino shape is attempting to move.
+	// @return: True/false based on if tetromino moved or not.
+	bool attemptMove(GridTetromino& shape, int x, int y);
+
+	// Drops the tetromino shape vertically as far as it can legally go, using the board's
+	// column skyline to find the drop distance in one step.
+	// @param shape: The tetromino shape that will drop.
+	void drop(GridTetromino& shape) const;
+
+	// Copy the Tetrmono shape contents (color) onto the grid.
+	// @param shape: The tetromino shape whose contents will be added to the grid.
+	void lock(GridTetromino& shape);
+
+	// Drops the Ghost Shape as far as it will go to represent where the current
+	// shape will fall. Only called when ghostShapeDirty is set.
+	void updateGhostShape() const;
+
+	// Raise a GameEvent to be collected by takeEvents().
+	void raiseEvent(GameEvent event) { pendingEvents |= static_cast<unsigned int>(event); }
+
+	// Determines if a Tetromino can legally be placed at its current position on the gameboard.
+	// A Tetrmino can be legally placed if it is within the gameboard and all the locations it inhabits are empty.
+	// Borders and occupancy are checked in a single pass against the board's row masks.
+	// @param shape: The tetromino shape being tested if its in a legal position.
+	bool isPositionLegal(const GridTetromino& shape) const;
+
+	// Determines if a Tetromino is within the left, right, & bottom gameboard borders (ignore the upper for spawning purposes)
+	// @param shape: The tetromino shape being tested if its within borders of gameboard.
+	// @return: bool, true if the shape is within the left, right, and lower border of the grid.
+	bool isWithinBorders(const GridTetromino& shape) const;
+
+	// set secsPerTick
+	//   - basic: use MAX_SECS_PER_TICK
+	//   - advanced: base it on score (higher score results in lower secsPerTick)
+	//   - raises LevelUp if the tick rate got faster
+	// params: none
+	// return: nothing
+	void determineSecondsPerTick();
+};
+
+// The engine of the standard game.
+typedef BasicTetrisEngine<Gameboard::MAX_X, Gameboard::MAX_Y> TetrisEngine;
@@ -1,164 +1,126 @@
 #pragma once
 
-#include "Gameboard.h"
-#include "GridTetromino.h"
-#include <SFML/Graphics.hpp>
-#include <SFML/Audio.hpp>
-
-enum class GameLoopState {
-	Playing,
-	GameOver,
-	Resetting
-};
-
+#include "TetrisEngine.h"
+#include "Replay.h"
+#include "RenderSnapshot.h"
+#include "TripleBuffer.h"
+#include "InputHandler.h"
+#include "GameAudio.h"
+#include "BeamSearch.h"
+#include "SelfPlay.h"
+#include <SFML/Window.hpp>
+#include <memory>
+
+/*
+ * The TetrisGame class is the interactive front end of a TetrisEngine: it maps keyboard events to
+ * engine inputs, steps the engine at a fixed rate, plays music/sounds in response to engine events
+ * (once its GameAudio is attached), can play itself with a HeuristicPolicy or a BeamSearchPolicy
+ * (demo mode) and publishes a RenderSnapshot after every batch of steps for a TetrisRenderer to
+ * draw, possibly on another thread. All game rules live in TetrisEngine.
+ */
 class TetrisGame {
 public:
 	// Static Constants ============================================================================
-	static const int BLOCK_WIDTH;			  // Pixel width of a tetris block
-	static const int BLOCK_HEIGHT;			  // Pixel height of a tetris block
-	static const double MAX_SECONDS_PER_TICK; // The slowest "tick" rate (in seconds)
-	static const double MIN_SECONDS_PER_TICK; // The fastest "tick" rate (in seconds)
+	static const double LOGIC_STEP_SECONDS;	  // Fixed time the engine is stepped by (240 Hz)
+	static const double MAX_FRAME_SECONDS;	  // Longest frame caught up on, so a stall can't snowball
+	static const double DEMO_INPUT_SECONDS;	  // Time between the inputs of the demo player
 
-private:	
+private:
 	// State members ===============================================================================
-	int score;					// The current game score.
-    Gameboard board;			// The gameboard (grid) to represent where all the blocks are.
-	GridTetromino currentShape;	// The tetromino that is currently falling.
-    GridTetromino nextShape;	// The tetromino that is "on deck".
-	GridTetromino ghostShape;	// The tetromino that displays where the currentShape will fall.
-	GameLoopState gameLoopState;
-	sf::Clock gameOverClock;	// Forces game to reset after the gameOver Sound
-	
-	// Graphics members ============================================================================
-	sf::Sprite& blockSprite;		// The sprite used for all the blocks.
-	sf::RenderWindow& window;		// The window the game is drawn on.
-	const Point gameboardOffset;	// Pixel XY offset of the gameboard on the screen
-	const Point nextShapeOffset;	// Pixel XY offset of the nextShape
-	sf::Font scoreFont;				// SFML font for displaying the score.
-	sf::Text scoreText;				// SFML text object for displaying the score
+	TetrisEngine engine;		// The game rules & state being presented.
+	Replay replay;				// Recording of everything played in this window.
+	InputHandler input;			// Key state, DAS & ARR.
+
+	// Render members ==============================================================================
+	TripleBuffer<RenderSnapshot> snapshots;	// Latest engine state, handed to the renderer.
+	std::uint32_t boardVersion{ 0 };	// Bumped when a shape locks, rows clear or the game resets.
+
+	// Fixed timestep members ======================================================================
+	double logicAccumulator{ 0.0 };	// Frame time not yet consumed by fixed logic steps.
+	double logicTime{ 0.0 };		// Total time stepped, the time base of input events.
+	sf::Clock sinceLastLoop;		// Time since the last processGameLoop(), to timestamp input events.
 
 	// Music members ===============================================================================
-	sf::Music tetrisMusic;		     // The Music for the Tetris Game
-	sf::Sound gameOver;			     // Sound for game over
-	sf::SoundBuffer gameOverBuffer;  
+	std::unique_ptr<GameAudio> audio;	// Music & sounds, null until attached.
 
-	
-	// Time members ================================================================================
-	double secondsPerTick = MAX_SECONDS_PER_TICK;   // The seconds per tick (Time for block to fall one line)	
-	double secondsSinceLastTick{ 0.0 };				// To determine if its time to tick
-	bool shapePlacedSinceLastGameLoop{ false };		// Tracks whether a shape has been placed in the current gameloop
+	// Demo members ================================================================================
+	std::unique_ptr<PlacementPolicy> demoPlayer;	// Plays the game while set.
+	int demoLookahead{ 1 };				// # of shapes the demo player looks at, 1 for no search.
+	Placement demoTarget;				// Where the demo player is steering the current shape.
+	bool demoTargetChosen{ false };		// Cleared when a new shape spawns.
+	double demoNextInputTime{ 0.0 };	// Logic time of the demo player's next input.
 
 public:
 	// Constructor
-	// Resets the game to its initial State
-	// @param window: Where the Tetris Game will be held
-	// @param blockSprite: The Sprite used for all Tetrominos
-	// @param gameboardOffset: The offset of the Gameboard on the Window
-	// @param nextShapeOffset: The offset of the nextShape on the Gameboard
-	TetrisGame(sf::RenderWindow& window, sf::Sprite& blockSprite, const Point& gameboardOffset, const Point& nextShapeOffset);
+	// Starts a new game and publishes its first snapshot. The game is silent until attachAudio().
+	// @param seed: Seed of the game's randomizer
+	explicit TetrisGame(std::uint64_t seed);
 
 	// Event and game loop processing ==============================================================
 
-	// Draws everything to do with the game (board, curentShape, nextShape, score)
-	// Called every gameloop 
-	void draw();								
-
-	// Handles keypress events for the game (up, left, right, down, space) 
-	// and updates the state of the game accordingly.
+	// Handles keypress events for the game (up, left, right, down, space) by timestamping the
+	// matching GameInput for the InputHandler, which applies it from the next logic step.
+	// D toggles the demo mode; any game key ends it.
 	// @param event: The keyboard event that maps to a command.
 	void onKeyPressed(const sf::Event& event);
 
-	// Called every game loop to handle ticks & tetromino placement/ locking.
-	// @param secondsSinceLastLoop: Float - Time elapsed since last tick.
+	// Handles key release events, ending the auto repeat of left, right & down.
+	// @param event: The keyboard event that maps to a command.
+	void onKeyReleased(const sf::Event& event);
+
+	// Attach the music & sounds once they have loaded. The music starts if a game is in progress.
+	// @param audio: The loaded audio, ignored if null.
+	void attachAudio(std::unique_ptr<GameAudio> audio);
+
+	// Let the game play itself (attract mode) or hand it back to the player.
+	// @param enabled: True to start the demo player.
+	void setDemoMode(bool enabled);
+	bool isDemoMode() const { return demoPlayer != nullptr; }
+
+	// Set how far the demo player looks ahead, from the next time the demo mode starts.
+	// @param shapes: 1 to only place the current shape, 2 to look at the next shape too, more
+	//                to look at the shapes after it with a beam search on every core.
+	void setDemoLookahead(int shapes) { demoLookahead = shapes; }
+
+	// Set the DAS & ARR timings.
+	void setInputConfig(const InputHandler::Config& config) { input.setConfig(config); }
+
+	// Called every game loop to step the engine, react to what happened in it and publish a snapshot.
+	// The engine is only ever stepped by LOGIC_STEP_SECONDS, as many times as the accumulated
+	// frame time allows, so the simulation doesn't depend on the frame rate.
+	// @param secondsSinceLastLoop: Float - Time elapsed since the last call.
 	void processGameLoop(float secondsSinceLastLoop);
 
-	// Returns the corresponding score for the amount of rows completed at once.
-	// @param rows: The amount of completed rows on the board.
-	// @return: The score attained from the amount of rows comppleted.
-	int getScoresFromRows(int rows) const;
+	// Get the snapshots published by processGameLoop(). The renderer (a single reader thread)
+	// takes the newest one with update() and draws read().
+	TripleBuffer<RenderSnapshot>& getSnapshots() { return snapshots; }
+
+	// Save the recording of everything played so far (e.g. to attach to a bug report).
+	// @param path: The file to write.
+	// @return: True if the file was written.
+	bool saveReplay(const std::string& path) { return replay.saveToFile(path); }
 
-	// A tick forces the currentShape to move down by one square. If not successfull, 
-	// it is locked into the gameboard.
-	void tick();
+	// Get the engine being presented (read only).
+	const TetrisEngine& getEngine() const { return engine; }
 
 private:
-	// Reset everything for a new game 
-	//  - Clear the gameboard and set the score to 0.
-	//  - Determine the tick rate.
-	//  - Pick and spawn the next shape and pick the shape on deck.
-	void reset();
-
-	// Selects a random tetShape and tetColor for the next Shape to be used in the game.
-	void pickNextShape();
-
-	// copy the nextShape into the currentShape (through assignment)
-	//   position the currentShape to its spawn location.
-	//	 @return: True/false based on if currentShape is in a legal position.
-	bool spawnNextShape();																	
-
-	// Test to see if a rotation is legal on the tetromino and if so, rotates it.
-	// @param shape: The tetromino shape that is attempting to rotate.
-	// @return: True/false based on if tetromino rotated or not.
-	bool attemptRotate(GridTetromino& shape);
-   
-	// Test to see if a movement is legal on the tetromino and if so, moves it.
-	// @param shape: The tetromino shape that is attempting to move.
-	// @param x: The horizontal direction the tetromino shape is attempting to move.
-	// @param y: The vertical direction the tetromino shape is attempting to move.
-	// @return: True/false based on if tetromino moved or not.
-	bool attemptMove(GridTetromino& shape, int x, int y);												
-
-	// Drops the tetromino shape vertically as far as it can legally go.
-	// @param shape: The tetromino shape that will drop. 
-	void drop(GridTetromino& shape);
-
-	// Copy the Tetrmono shape contents (color) onto the grid. 
-	// @param shape: The tetromino shape whose contents will be added to the grid. 
-	void lock(GridTetromino& shape);
-
-	// Drops the Ghost Shape as far as it will go to represent where the current
-	// shape will fall.
-	void updateGhostShape();
-	
-	// Graphics methods =================================================================================
-	
-	// Draws a tetris block sprite on the canvas in the window. 
-	// The block position is specified in terms of 2 offsets (top left of gameboard and x, y offset into the gameboard.
-	// @param topLeft: Top left of the gameboard in pixels.
-	// @param xOffset: The x-Offset of new shape on the board in blocks.
-	// @param yOffset: The y-offset of new shape on the board in blocks.
-	// @param color: The color of the new shape
-	void drawBlock(const Point& topLeft, int xOffset, int yOffset, const TetColor& color, float alpha);
-										
-	// Draws the gameboard blocks on the window by iterating through each row and col and drawing each block. 
-	// Only draws the blocks that are not empty.
-	void drawGameboard();
-	
-	// Draws a tetromino on the window. 
-	// @param shape: The tetromino shape to be drawn onto the canvas.
-	// @param p: The 'base pont' from which to calculate block offsets.
-	void drawTetromino(GridTetromino& shape, const Point& p, float alpha);
-	
-	// Updates the score display by forming the string "score: ####"
-	void updateScoreDisplay();
-
-	// State & gameplay/logic methods ======================================================================
-
-	// Determines if a Tetromino can legally be placed at its current position on the gameboard.
-	// A Tetrmino can be legally placed if it is within the gameboard and all the locations it inhabits are empty. 
-	// @param shape: The tetromino shape being tested if its in a legal position. 
-	bool isPositionLegal(const GridTetromino& shape) const;
-
-	// Determines if a Tetromino is within the left, right, & bottom gameboard borders (ignore the upper for spawning purposes)
-	// @param shape: The tetromino shape being tested if its within borders of gameboard.
-	// @return: bool, true if the shape is within the left, right, and lower border of the grid. 
-	bool isWithinBorders(const GridTetromino& shape) const;
-
-
-	// set secsPerTick 
-	//   - basic: use MAX_SECS_PER_TICK
-	//   - advanced: base it on score (higher score results in lower secsPerTick)
-	// params: none
-	// return: nothing
-	void determineSecondsPerTick();
+	// Plays music/sounds and tracks board changes for the events raised by the engine.
+	// @param events: GameEvent flags returned by TetrisEngine::takeEvents().
+	void handleEngineEvents(unsigned int events);
+
+	// Feed the demo player's next input to the engine once it is due, choosing where the current
+	// shape goes when it spawns. Called before every logic step while the demo mode is on.
+	void stepDemo();
+
+	// Map a key to the input it controls.
+	// @param key: The key.
+	// @param gameInput: Set to the mapped input.
+	// @return: False if the key isn't mapped.
+	bool mapKey(sf::Keyboard::Key key, GameInput& gameInput) const;
+
+	// Get the current time in the time base of the logic steps, for input events.
+	double getInputTime() const;
+
+	// Copy the engine state into the snapshot buffer and publish it.
+	void publishSnapshot();
 };
@@ -0,0 +1,62 @@
+#include "TetrisRenderer.h"
+#include <string>
+
+
+// STATIC CONSTANTS ======================================
+
+const int TetrisRenderer::BLOCK_WIDTH{ 32 };
+const int TetrisRenderer::BLOCK_HEIGHT{ 32 };
+
+// CONSTRUCTOR -------------------------------------------
+
+TetrisRenderer::TetrisRenderer(sf::Vector2u size, const sf::Texture& backgroundTexture, const sf::Texture& blockTexture,
+	const Point& gameboardOffset, const Point& nextShapeOffset, const sf::Font& scoreFont)
+	: gameboardOffset(gameboardOffset), nextShapeOffset(nextShapeOffset), background(backgroundTexture),
+	  boardBlocks(blockTexture, Gameboard::MAX_X * Gameboard::MAX_Y), shapeBlocks(blockTexture, 3 * Tetromino::BLOCK_COUNT)
+{
+	if (!staticLayer.create(size.x, size.y)) {
+		assert(false && "Could not create the static layer render texture");
+	}
+	staticLayerSprite.setTexture(staticLayer.getTexture());
+
+	scoreText.setFont(scoreFont);
+	scoreText.setCharacterSize(18);
+	scoreText.setFillColor(sf::Color::White);
+	scoreText.setPosition(425, 325);
+}
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+void TetrisRenderer::draw(sf::RenderTarget& target, const RenderSnapshot& snapshot) {
+	if (!hasStaticLayer || snapshot.boardVersion != staticLayerVersion) {
+		redrawStaticLayer(snapshot);
+	}
+	target.draw(staticLayerSprite);
+
+	shapeBlocks.setShapeSlots(0, snapshot.ghostShape, gameboardOffset, BlockBatch::GHOST_ALPHA);
+	Point currentOffset = gameboardOffset;
+	if (smoothFall && snapshot.currentShape.getGridLoc().getY() < snapshot.ghostShape.getGridLoc().getY()) {
+		currentOffset.setY(gameboardOffset.getY() + static_cast<int>(snapshot.tickProgress * BLOCK_HEIGHT));
+	}
+	shapeBlocks.setShapeSlots(Tetromino::BLOCK_COUNT, snapshot.currentShape, currentOffset, 255);
+	shapeBlocks.setShapeSlots(2 * Tetromino::BLOCK_COUNT, snapshot.nextShape, nextShapeOffset, 255);
+	target.draw(shapeBlocks);
+
+	if (snapshot.score != displayedScore) {
+		displayedScore = snapshot.score;
+		scoreText.setString("score: " + std::to_string(displayedScore));
+	}
+	target.draw(scoreText);
+}
+
+// PRIVATE METHODS ---------------------------------------
+
+void TetrisRenderer::redrawStaticLayer(const RenderSnapshot& snapshot) {
+	boardBlocks.setBoardSlots(0, snapshot.board, gameboardOffset);
+	staticLayer.clear(sf::Color::White);
+	staticLayer.draw(background);
+	staticLayer.draw(boardBlocks);
+	staticLayer.display();
+	staticLayerVersion = snapshot.boardVersion;
+	hasStaticLayer = true;
+}
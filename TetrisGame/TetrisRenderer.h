@@ -0,0 +1,58 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include "BlockBatch.h"
+#include "RenderSnapshot.h"
+
+/*
+ * The TetrisRenderer class draws RenderSnapshots of a game onto a render target. It only reads
+ * snapshots, never the engine, so it can run on its own thread while the game logic keeps stepping.
+ * The background & locked blocks are cached in an offscreen layer that is only redrawn when the
+ * snapshot's board version changes; the shapes are drawn every frame in a single draw call.
+ */
+class TetrisRenderer {
+public:
+	// Static Constants ============================================================================
+	static const int BLOCK_WIDTH;			  // Pixel width of a tetris block
+	static const int BLOCK_HEIGHT;			  // Pixel height of a tetris block
+
+private:
+	const Point gameboardOffset;	// Pixel XY offset of the gameboard on the screen
+	const Point nextShapeOffset;	// Pixel XY offset of the nextShape
+	sf::Sprite background;			// The background, drawn into the static layer.
+	BlockBatch boardBlocks;			// The locked blocks, drawn into the static layer.
+	BlockBatch shapeBlocks;			// The ghost, current & next shapes, drawn every frame.
+	sf::RenderTexture staticLayer;	// Background & locked blocks, composited offscreen.
+	sf::Sprite staticLayerSprite;	// Draws the static layer onto the target.
+	bool hasStaticLayer{ false };	// False until the static layer was drawn once.
+	std::uint32_t staticLayerVersion{ 0 };	// Board version the static layer shows.
+	sf::Text scoreText;				// SFML text object for displaying the score
+	int displayedScore{ -1 };		// Score shown by scoreText.
+	bool smoothFall{ false };		// Slide the current shape between rows as its tick nears.
+
+public:
+	// Constructor
+	// Creates the static layer.
+	// @param size: Size of the target in pixels.
+	// @param backgroundTexture: The window background
+	// @param blockTexture: The tile sheet used for all Tetrominos, one BLOCK_WIDTH column per TetColor
+	// @param gameboardOffset: The offset of the Gameboard on the Window
+	// @param nextShapeOffset: The offset of the nextShape on the Gameboard
+	// @param scoreFont: Font of the score, must outlive the renderer
+	TetrisRenderer(sf::Vector2u size, const sf::Texture& backgroundTexture, const sf::Texture& blockTexture,
+		const Point& gameboardOffset, const Point& nextShapeOffset, const sf::Font& scoreFont);
+
+	// Draws everything (background, board, curentShape, nextShape, score) of a snapshot.
+	// @param target: Where to draw.
+	// @param snapshot: The game state to draw.
+	void draw(sf::RenderTarget& target, const RenderSnapshot& snapshot);
+
+	// Interpolate the current shape's fall between ticks. Display only, the engine still moves
+	// it a whole row per tick.
+	// @param enabled: True to slide the shape smoothly.
+	void setSmoothFall(bool enabled) { smoothFall = enabled; }
+
+private:
+	// Composite the background & the locked blocks of a snapshot into the static layer.
+	void redrawStaticLayer(const RenderSnapshot& snapshot);
+};
@@ -1,52 +1,91 @@
 #pragma once
 #include <vector>
+#include <array>
+#include <cstdint>
 #include "Point.h"
 #include <algorithm>
 
 // -------------- COLORS AND SHAPES -------------- //
 
 // Available Colors for each Tetromino
-enum class TetColor { RED, ORANGE, YELLOW, GREEN, BLUE_LIGHT, BLUE_DARK, PURPLE, COUNT };
+enum class TetColor : std::uint8_t { RED, ORANGE, YELLOW, GREEN, BLUE_LIGHT, BLUE_DARK, PURPLE, COUNT };
 
 // Available Shapes for each Tetromino
-enum class TetShape { S, Z, L, J, O, I, T, COUNT };  
+enum class TetShape : std::uint8_t { S, Z, L, J, O, I, T, COUNT };
 
 
 // --------------- TETROMINO CLASS --------------- //
 
-// Tetromino class represents a Tetris game piece with color, shape, and block locations
+// Tetromino class represents a Tetris game piece with color, shape, and orientation.
+// Block locations are looked up in a compile-time table, so a Tetromino is a few bytes,
+// trivially copyable, and rotating it never allocates.
 class Tetromino {
 	friend class TestSuite;
 
+public:
+	static const int BLOCK_COUNT = 4;		 // # of blocks in a Tetromino
+	static const int ORIENTATION_COUNT = 4;  // # of clockwise orientations of a Tetromino
+
+	typedef std::array<Point, BLOCK_COUNT> BlockLocs;  // Points (X,Y Coordinates) of a Tetromino.
+
 private:
+	// Block locations of every shape in every orientation. Orientation n + 1 is orientation n
+	// rotated 90 degrees clockwise about [0,0] ([x,y] -> [y,-x]).
+	static constexpr BlockLocs SHAPE_TABLE[static_cast<int>(TetShape::COUNT)][ORIENTATION_COUNT] = {
+		{ // S
+			{{ Point(0,1), Point(1,1), Point(0,0), Point(-1,0) }},
+			{{ Point(1,0), Point(1,-1), Point(0,0), Point(0,1) }},
+			{{ Point(0,-1), Point(-1,-1), Point(0,0), Point(1,0) }},
+			{{ Point(-1,0), Point(-1,1), Point(0,0), Point(0,-1) }},
+		},
+		{ // Z
+			{{ Point(-1,1), Point(0,1), Point(0,0), Point(1,0) }},
+			{{ Point(1,1), Point(1,0), Point(0,0), Point(0,-1) }},
+			{{ Point(1,-1), Point(0,-1), Point(0,0), Point(-1,0) }},
+			{{ Point(-1,-1), Point(-1,0), Point(0,0), Point(0,1) }},
+		},
+		{ // L
+			{{ Point(0,1), Point(0,0), Point(0,-1), Point(1,-1) }},
+			{{ Point(1,0), Point(0,0), Point(-1,0), Point(-1,-1) }},
+			{{ Point(0,-1), Point(0,0), Point(0,1), Point(-1,1) }},
+			{{ Point(-1,0), Point(0,0), Point(1,0), Point(1,1) }},
+		},
+		{ // J
+			{{ Point(0,1), Point(0,0), Point(0,-1), Point(-1,-1) }},
+			{{ Point(1,0), Point(0,0), Point(-1,0), Point(-1,1) }},
+			{{ Point(0,-1), Point(0,0), Point(0,1), Point(1,1) }},
+			{{ Point(-1,0), Point(0,0), Point(1,0), Point(1,-1) }},
+		},
+		{ // O
+			{{ Point(0,1), Point(1,1), Point(0,0), Point(1,0) }},
+			{{ Point(1,0), Point(1,-1), Point(0,0), Point(0,-1) }},
+			{{ Point(0,-1), Point(-1,-1), Point(0,0), Point(-1,0) }},
+			{{ Point(-1,0), Point(-1,1), Point(0,0), Point(0,1) }},
+		},
+		{ // I
+			{{ Point(0,2), Point(0,1), Point(0,0), Point(0,-1) }},
+			{{ Point(2,0), Point(1,0), Point(0,0), Point(-1,0) }},
+			{{ Point(0,-2), Point(0,-1), Point(0,0), Point(0,1) }},
+			{{ Point(-2,0), Point(-1,0), Point(0,0), Point(1,0) }},
+		},
+		{ // T
+			{{ Point(-1,0), Point(0,0), Point(1,0), Point(0,-1) }},
+			{{ Point(0,1), Point(0,0), Point(0,-1), Point(-1,0) }},
+			{{ Point(1,0), Point(0,0), Point(-1,0), Point(0,1) }},
+			{{ Point(0,-1), Point(0,0), Point(0,1), Point(1,0) }},
+		},
+	};
+
 	TetColor color;
 	TetShape shape;
-	static std::vector<TetShape> randomShapes;
-
-protected:
-	std::vector<Point> blockLocs{}; // Points (X,Y Coordinates) of Tetromino.
+	std::uint8_t orientation;  // Index into SHAPE_TABLE, 0 is the spawn orientation.
 
 public:
-	// Tetromino Constructor defaults to a Red J.
-	Tetromino() 
-		: color(TetColor::RED), shape(TetShape::S), blockLocs{ 
-			Point(0,1), Point(0,0), Point(0,-1), Point(-1,-1) }
-	{}
-
-	// Copy Constructor
-	Tetromino(const Tetromino& other)
-		: color(other.color), shape(other.shape), blockLocs(other.blockLocs)
+	// Tetromino Constructor defaults to a Red S.
+	Tetromino()
+		: color(TetColor::RED), shape(TetShape::S), orientation(0)
 	{}
 
-	// Fill vector of random shapes (two of each) to pull from.
-	static void fillRandomShapes();
-
-	// Get a random TetShape from the random shapes vector, if empty refill it. 
-	static TetShape getRandomShape();
-
-	// Get a random TetColor.
-	static TetColor getRandomColor();
-
 	// Get the color of the Tetromino.
 	TetColor getColor() const { return color; }
 
@@ -56,9 +95,21 @@ public:
 	// Get the shape of the Tetromino.
 	TetShape getShape() const { return shape; }
 
-	// Set the shape of the Tetromino.
+	// Set the shape of the Tetromino and reset it to its spawn orientation.
 	void setShape(TetShape shape);
 
+	// Get the orientation of the Tetromino (number of clockwise rotations from spawn, 0-3).
+	int getOrientation() const { return orientation; }
+
+	// Set the orientation of the Tetromino (number of clockwise rotations from spawn, 0-3).
+	void setOrientation(int orientation) { this->orientation = static_cast<std::uint8_t>(orientation % ORIENTATION_COUNT); }
+
+	// Get the block locations of the Tetromino relative to its rotation point.
+	const BlockLocs& getBlockLocs() const { return SHAPE_TABLE[static_cast<int>(shape)][orientation]; }
+
+	// Get the block locations of a shape in a given orientation relative to its rotation point.
+	static const BlockLocs& getBlockLocs(TetShape shape, int orientation) { return SHAPE_TABLE[static_cast<int>(shape)][orientation]; }
+
 	// Rotate the Tetromino 90 degrees clockwise.
 	void rotateClockwise();
 
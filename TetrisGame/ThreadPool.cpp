@@ -0,0 +1,79 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+// CONSTRUCTOR -------------------------------------------
+
+ThreadPool::ThreadPool(int threads) {
+	if (threads <= 0) {
+		threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	}
+	for (int i = 1; i < threads; i++) {
+		workers.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread& t : workers) {
+		t.join();
+	}
+}
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+void ThreadPool::run(int tasks, const Job& job) {
+	if (workers.empty() || tasks <= 1) {
+		for (int task = 0; task < tasks; task++) {
+			job(task, 0);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->job = &job;
+		taskCount = tasks;
+		nextTask = 0;
+		busyWorkers = static_cast<int>(workers.size());
+		batch++;
+	}
+	wake.notify_all();
+	runTasks(0);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this]() { return busyWorkers == 0; });
+	this->job = nullptr;
+}
+
+// PRIVATE METHODS ---------------------------------------
+
+void ThreadPool::runTasks(int thread) {
+	for (int task = nextTask++; task < taskCount; task = nextTask++) {
+		(*job)(task, thread);
+	}
+}
+
+void ThreadPool::workerLoop(int thread) {
+	unsigned int lastBatch{ 0 };
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [&]() { return stopping || batch != lastBatch; });
+			if (stopping) {
+				return;
+			}
+			lastBatch = batch;
+		}
+		runTasks(thread);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--busyWorkers == 0) {
+				finished.notify_one();
+			}
+		}
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * The ThreadPool class keeps worker threads alive between batches of work, so searches that run
+ * many short parallel steps don't pay for thread creation on every step. run() hands out a
+ * batch of tasks to the workers and to the calling thread, and returns once all are done.
+ * One batch runs at a time; run() must not be called from inside a task.
+ */
+class ThreadPool {
+public:
+	// A task of a batch.
+	// @param task: Index of the task, 0 to the batch size - 1.
+	// @param thread: Index of the thread running it, 0 (the caller) to getThreadCount() - 1.
+	typedef std::function<void(int task, int thread)> Job;
+
+private:
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wake;		// Signals a new batch or stopping to the workers
+	std::condition_variable finished;	// Signals the caller that the last worker is done
+	const Job* job{ nullptr };			// Job of the current batch
+	int taskCount{ 0 };					// # of tasks of the current batch
+	std::atomic<int> nextTask{ 0 };		// Next task to hand out
+	int busyWorkers{ 0 };				// Workers still running tasks of the current batch
+	unsigned int batch{ 0 };			// Bumped for every batch
+	bool stopping{ false };
+
+public:
+	// Constructor
+	// @param threads: # of threads running the tasks, the caller of run() included; 0 for one per core.
+	explicit ThreadPool(int threads);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Run a batch of tasks and wait for them to finish.
+	// @param tasks: # of tasks.
+	// @param job: Called once per task, from any thread of the pool.
+	void run(int tasks, const Job& job);
+
+	int getThreadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+private:
+	// Run tasks of the current batch until none are left.
+	void runTasks(int thread);
+
+	// Body of a worker thread.
+	void workerLoop(int thread);
+};
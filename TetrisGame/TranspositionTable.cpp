@@ -0,0 +1,111 @@
+#include "TranspositionTable.h"
+#include <algorithm>
+#include <cstring>
+
+// STATIC CONSTANTS ======================================
+
+const int TranspositionTable::BUCKET_ENTRIES;
+const int TranspositionTable::ENTRY_WORDS;
+
+// CONSTRUCTOR -------------------------------------------
+
+TranspositionTable::TranspositionTable(int bucketBits) {
+	bucketBits = std::max(0, std::min(bucketBits, 30));
+	bucketMask = (std::uint64_t(1) << bucketBits) - 1;
+	const std::size_t bucketWords{ static_cast<std::size_t>(BUCKET_ENTRIES) * ENTRY_WORDS };
+	const std::size_t count{ static_cast<std::size_t>(bucketMask + 1) * bucketWords };
+	storage.reset(new Word[count + bucketWords - 1]);
+
+	// Round up to the first cache line boundary.
+	std::uintptr_t address{ reinterpret_cast<std::uintptr_t>(storage.get()) };
+	std::uintptr_t aligned{ (address + sizeof(Word) * bucketWords - 1) & ~std::uintptr_t(sizeof(Word) * bucketWords - 1) };
+	entries = storage.get() + (aligned - address) / sizeof(Word);
+	clear();
+}
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+float TranspositionTable::store(std::uint64_t key, float score) {
+	Word* bucket = entries + (key & bucketMask) * BUCKET_ENTRIES * ENTRY_WORDS;
+
+	// Raise the score of the key's entry, or replace the least useful entry.
+	int victim{ 0 };
+	std::uint64_t victimData{ bucket[1].load(std::memory_order_relaxed) };
+	for (int i = 0; i < BUCKET_ENTRIES; i++) {
+		std::uint64_t currentKey;
+		std::uint64_t current{ read(bucket + i * ENTRY_WORDS, currentKey) };
+		bool currentIsStale{ getGeneration(current) != generation };
+		if (!currentIsStale && currentKey == key) {
+			if (getScore(current) >= score)
+				return getScore(current);
+			victim = i;
+			break;
+		}
+		else if (currentIsStale) {
+			if (getGeneration(victimData) == generation) {
+				victim = i;
+				victimData = current;
+			}
+		}
+		else if (getGeneration(victimData) == generation && getScore(current) < getScore(victimData)) {
+			victim = i;
+			victimData = current;
+		}
+	}
+
+	// A racing store can tear the entry: it then matches no key & is just lost.
+	const std::uint64_t data{ pack(score) };
+	Word* entry = bucket + victim * ENTRY_WORDS;
+	entry[1].store(data, std::memory_order_relaxed);
+	entry[0].store(key ^ data, std::memory_order_relaxed);
+	return score;
+}
+
+bool TranspositionTable::probe(std::uint64_t key, float& score) const {
+	const Word* bucket = entries + (key & bucketMask) * BUCKET_ENTRIES * ENTRY_WORDS;
+	for (int i = 0; i < BUCKET_ENTRIES; i++) {
+		std::uint64_t currentKey;
+		std::uint64_t current{ read(bucket + i * ENTRY_WORDS, currentKey) };
+		if (getGeneration(current) == generation && currentKey == key) {
+			score = getScore(current);
+			return true;
+		}
+	}
+	return false;
+}
+
+void TranspositionTable::newSearch() {
+	generation = (generation + 1) & 0xFF;
+	if (generation == 0) {
+		// The generations wrapped: entries of 255 searches ago would look current
+		clear();
+		generation = 1;
+	}
+}
+
+void TranspositionTable::clear() {
+	for (int i = 0; i < getEntryCount() * ENTRY_WORDS; i++) {
+		entries[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+// PRIVATE METHODS ---------------------------------------
+
+std::uint64_t TranspositionTable::pack(float score) const {
+	std::uint32_t bits;
+	std::memcpy(&bits, &score, sizeof(bits));
+	return (generation << 32) | bits;
+}
+
+std::uint64_t TranspositionTable::read(const Word* entry, std::uint64_t& key) {
+	std::uint64_t data{ entry[1].load(std::memory_order_relaxed) };
+	key = entry[0].load(std::memory_order_relaxed) ^ data;
+	return data;
+}
+
+float TranspositionTable::getScore(std::uint64_t data) {
+	std::uint32_t bits{ static_cast<std::uint32_t>(data) };
+	float score;
+	std::memcpy(&score, &bits, sizeof(score));
+	return score;
+}
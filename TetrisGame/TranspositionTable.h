@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/*
+ * The TranspositionTable class remembers the best score seen for each board of a search, so
+ * threads that reach the same board by different move orders can drop the worse copies. It has
+ * a fixed size & no locks: every entry is two atomic 64-bit words, the search generation & the
+ * score, and the full key XORed with them, so an entry only matches the exact key that was
+ * stored, and an entry torn by racing stores matches no key at all. The 4 entries of a bucket
+ * share one cache line, so a store or a probe costs one cache miss. A full bucket replaces an
+ * entry of an older search first, then the lowest score. Entries can be lost to replacement or
+ * to racing stores; the table then misses a duplicate, but never reports a score that wasn't
+ * stored for the key.
+ */
+class TranspositionTable {
+	friend class TestSuite;
+
+public:
+	static const int BUCKET_ENTRIES = 4;	// Entries per 64 byte bucket
+
+private:
+	// An entry is two words: the key ^ the data word, then the data word (generation & score).
+	// Both are 0 while the entry is empty.
+	typedef std::atomic<std::uint64_t> Word;
+	static const int ENTRY_WORDS = 2;
+
+	std::unique_ptr<Word[]> storage;	// The entries, plus slack to align the buckets
+	Word* entries{ nullptr };			// First entry of the first bucket, 64 byte aligned
+	std::uint64_t bucketMask{ 0 };		// Bucket count - 1
+	std::uint64_t generation{ 1 };		// Generation of the current search, never 0 (empty entries)
+
+public:
+	// Constructor
+	// @param bucketBits: log2 of the # of buckets.
+	explicit TranspositionTable(int bucketBits);
+
+	TranspositionTable(const TranspositionTable&) = delete;
+	TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+	// Store a score for a key, keeping the best one. Thread safe.
+	// @param key: Hash of the board (with anything else that tells searches apart).
+	// @param score: Score of the board.
+	// @return: The best score stored for the key in this search, score included.
+	float store(std::uint64_t key, float score);
+
+	// Look up the best score stored for a key in this search. Thread safe.
+	// @param key: Hash of the board.
+	// @param score: Set to the score if found.
+	// @return: True if the key was found.
+	bool probe(std::uint64_t key, float& score) const;
+
+	// Start a new search: entries stored before are ignored & replaced first. Not thread safe.
+	void newSearch();
+
+	// Empty every entry. Not thread safe.
+	void clear();
+
+	int getEntryCount() const { return static_cast<int>((bucketMask + 1) * BUCKET_ENTRIES); }
+
+private:
+	// Pack the generation & a score into the data word of an entry.
+	std::uint64_t pack(float score) const;
+
+	// Read an entry.
+	// @param entry: The first word of the entry.
+	// @param key: Set to the key it was stored for (garbage if torn or empty).
+	// @return: Its data word.
+	static std::uint64_t read(const Word* entry, std::uint64_t& key);
+
+	static std::uint64_t getGeneration(std::uint64_t data) { return (data >> 32) & 0xFF; }
+	static float getScore(std::uint64_t data);
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+/*
+ * The TripleBuffer class hands values from one writer thread to one reader thread without locks.
+ * The writer fills its own slot and publishes it; the reader takes the newest published slot.
+ * Neither side ever waits for the other: the writer may publish faster than the reader reads
+ * (older values are skipped), and the reader keeps the last value until a new one is published.
+ * T should be cheap to overwrite, since the writer reuses old slots.
+ */
+template <typename T>
+class TripleBuffer {
+private:
+	static const std::uint8_t INDEX_MASK = 0x3;	// Bits of the shared index holding a slot index.
+	static const std::uint8_t FRESH_BIT = 0x4;	// Set in the shared index by publish(), cleared by update().
+
+	T slots[3];
+	std::uint8_t writeIdx{ 0 };				// Slot owned by the writer.
+	std::atomic<std::uint8_t> sharedIdx{ 1 };	// Slot in between, plus FRESH_BIT.
+	std::uint8_t readIdx{ 2 };				// Slot owned by the reader.
+
+public:
+	// Writer: get the slot to fill. It holds stale data, every field must be written.
+	// @return: The writer's slot.
+	T& beginWrite() { return slots[writeIdx]; }
+
+	// Writer: make the filled slot the newest value, and take another slot to write next.
+	void publish() {
+		std::uint8_t previous = sharedIdx.exchange(static_cast<std::uint8_t>(writeIdx | FRESH_BIT), std::memory_order_acq_rel);
+		writeIdx = previous & INDEX_MASK;
+	}
+
+	// Reader: take the newest published value if there is one.
+	// @return: True if read() now returns a value it didn't return before.
+	bool update() {
+		if (!(sharedIdx.load(std::memory_order_relaxed) & FRESH_BIT)) {
+			return false;
+		}
+		std::uint8_t previous = sharedIdx.exchange(readIdx, std::memory_order_acq_rel);
+		readIdx = previous & INDEX_MASK;
+		return true;
+	}
+
+	// Reader: get the value taken by the last update().
+	// @return: The reader's slot, only modified by the reader's next update().
+	const T& read() const { return slots[readIdx]; }
+};
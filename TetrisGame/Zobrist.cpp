@@ -0,0 +1,35 @@
+#include "Zobrist.h"
+#include "Randomizer.h"
+
+// CONSTRUCTOR -------------------------------------------
+
+template<int Width, int Height>
+ZobristKeys<Width, Height>::ZobristKeys() {
+	Pcg32 rng(0x5EED2B1575ull, Width * 1000 + Height);
+	auto next64 = [&rng]() {
+		// Two statements, so the high half is always drawn first whatever the compiler
+		std::uint64_t hi{ rng.next() };
+		std::uint64_t lo{ rng.next() };
+		return (hi << 32) | lo;
+	};
+	for (int y = 0; y < Height; y++) {
+		for (int x = 0; x < Width; x++)
+			cells[y][x] = next64();
+	}
+	for (std::uint64_t& key : depths)
+		key = next64();
+}
+
+// MEMBER FUNCTIONS ---------------------------------------
+
+template<int Width, int Height>
+const ZobristKeys<Width, Height>& ZobristKeys<Width, Height>::get() {
+	static const ZobristKeys keys;
+	return keys;
+}
+
+// EXPLICIT INSTANTIATIONS -------------------------------
+
+template class ZobristKeys<10, 19>;
+template class ZobristKeys<32, 64>;
+template class ZobristKeys<40, 100>;
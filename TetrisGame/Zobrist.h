@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+
+/*
+ * The ZobristKeys class template holds the random 64-bit keys boards are hashed with: one per
+ * cell & one per search depth. A board's hash is the XOR of the keys of its filled cells, so
+ * filling or clearing a cell updates it with a single XOR, and equal boards hash equally however
+ * they were built. The keys come from a fixed seed: hashes are the same in every run.
+ * Members are explicitly instantiated in Zobrist.cpp for the sizes listed there.
+ */
+template<int Width, int Height>
+class ZobristKeys {
+public:
+	static const int MAX_DEPTH = 64;	// # of depth keys
+
+private:
+	std::uint64_t cells[Height][Width];
+	std::uint64_t depths[MAX_DEPTH];
+
+	ZobristKeys();
+
+public:
+	// Get the keys of this board size, generated on first use.
+	static const ZobristKeys& get();
+
+	std::uint64_t getCellKey(int x, int y) const { return cells[y][x]; }
+	std::uint64_t getDepthKey(int depth) const { return depths[depth % MAX_DEPTH]; }
+
+	// Get the XOR of the keys of the filled cells of a row.
+	// @param y: The row.
+	// @param mask: Its occupancy, bit x for column x.
+	std::uint64_t getRowKey(int y, std::uint64_t mask) const {
+		std::uint64_t key{ 0 };
+		for (int x = 0; mask != 0; x++, mask >>= 1) {
+			if (mask & 1)
+				key ^= cells[y][x];
+		}
+		return key;
+	}
+};